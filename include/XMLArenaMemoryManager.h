@@ -0,0 +1,150 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLArenaMemoryManager_h
+#define _INCLUDED_XMLArenaMemoryManager_h 0
+
+// ----------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <vector>
+
+#include <xercesc/framework/MemoryManager.hpp>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// This is a Xerces memory manager that carves its memory out of large chunks
+// (an arena), instead of going to the global heap for every allocation.
+// Each pooled SAX parser gets its own, so Xerces allocations of different
+// parsing threads never contend in the global allocator.
+//
+// Freed blocks go to a free list per size class (powers of two) and are
+// handed out again to the next allocation of that class. Everything that
+// Xerces allocates and frees during one document is therefore reused by
+// the next document. In steady state a parse doesn't touch the global heap.
+// Allocations larger than the largest size class go to the heap directly.
+//
+// NOTE: Rolling the whole arena back between documents is not an option,
+//       because Xerces keeps some of its objects (the scanner, its buffers,
+//       grammars, ...) alive across documents. That is why reset() only
+//       starts a new set of per-document counters.
+//
+// NOTE: This is deliberately not thread-safe. A pooled SAX parser is used
+//       by one XMLParser (and so one thread) at a time.
+//
+class   XMLArenaMemoryManager : public XERCES_CPP_NAMESPACE::MemoryManager  {
+
+    public:
+
+        typedef std::size_t size_type;
+
+        explicit XMLArenaMemoryManager (size_type chunk_size = 256 * 1024)
+            throw ();
+        ~XMLArenaMemoryManager () throw ();
+
+       // Xerces MemoryManager interface
+       //
+        void *allocate (XMLSize_t size);
+        void deallocate (void *p);
+        XERCES_CPP_NAMESPACE::MemoryManager *getExceptionMemoryManager ();
+
+       // Starts a new document as far as the counters below are concerned
+       //
+        inline void reset () throw ()  {
+
+            bytes_allocated_ = 0;
+            heap_allocations_ = 0;
+        }
+
+       // Bytes handed out to Xerces since the last reset()
+       //
+        inline size_type bytes_allocated () const throw ()  {
+
+            return (bytes_allocated_);
+        }
+
+       // Number of trips to the global heap (for new chunks or large blocks)
+       // since the last reset()
+       //
+        inline size_type heap_allocations () const throw ()  {
+
+            return (heap_allocations_);
+        }
+
+       // Total size of the chunks owned by this arena
+       //
+        inline size_type arena_size () const throw ()  {
+
+            return (arena_size_);
+        }
+
+    private:
+
+       // Every block is preceded by this header, which also keeps the
+       // returned memory 16 bytes aligned.
+       //
+        struct  BlockHeader  {
+
+            size_type   size_class;
+            size_type   padding;
+        };
+
+        struct  FreeBlock  {
+
+            FreeBlock   *next;
+        };
+
+        enum  {
+            MIN_CLASS_SHIFT = 4,   // 16 bytes
+            NUM_CLASSES = 13,      // Up to 64 KB
+            LARGE_BLOCK = NUM_CLASSES
+        };
+
+        static inline size_type size_class_ (size_type size) throw ()  {
+
+            size_type   sc = 0;
+
+            size -= 1;
+            size >>= MIN_CLASS_SHIFT;
+            while (size)  {
+                size >>= 1;
+                sc += 1;
+            }
+            return (sc);
+        }
+
+        char *carve_ (size_type block_size);
+
+        const   size_type   chunk_size_;
+        std::vector<char *> chunks_;
+        char                *cur_;
+        char                *end_;
+        size_type           arena_size_;
+        FreeBlock           *free_lists_ [NUM_CLASSES];
+        size_type           bytes_allocated_;
+        size_type           heap_allocations_;
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLArenaMemoryManager (const XMLArenaMemoryManager &);
+        XMLArenaMemoryManager &operator = (const XMLArenaMemoryManager &);
+};
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLArenaMemoryManager_h
+#define _INCLUDED_XMLArenaMemoryManager_h 1
+#endif    // _INCLUDED_XMLArenaMemoryManager_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,239 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLAsyncIngest_h
+#define _INCLUDED_XMLAsyncIngest_h 0
+
+// ----------------------------------------------------------------------------
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <XMLParser.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// A parsed document that owns its tree, along with the problems found while
+// parsing it.
+//
+class   XMLDocument  {
+
+    public:
+
+        typedef XMLParser::XmlErrorVector   XmlErrorVector;
+
+        inline XMLDocument () : root_ (attr_vector_)  {   }
+
+        inline const XMLTreeNodes &get_root () const throw ()  {
+
+            return (root_);
+        }
+        inline bool has_fatal_error () const throw ()  {
+
+            return (! fatal_error_.empty ());
+        }
+        inline const std::string &fatal_error () const throw ()  {
+
+            return (fatal_error_);
+        }
+        inline const XmlErrorVector &errors () const throw ()  {
+
+            return (error_msgs_);
+        }
+        inline const XmlErrorVector &warnings () const throw ()  {
+
+            return (warning_msgs_);
+        }
+
+    private:
+
+        friend  class   XMLAsyncIngest;
+
+       // The attribute vector must be constructed before, and destroyed
+       // after, the tree that refers to it.
+       //
+        XMLTreeNodes::attr_vector   attr_vector_;
+        XMLTreeNodes                root_;
+
+        std::string     fatal_error_;
+        XmlErrorVector  error_msgs_;
+        XmlErrorVector  warning_msgs_;
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLDocument (const XMLDocument &);
+        XMLDocument &operator = (const XMLDocument &);
+};
+
+// ----------------------------------------------------------------------------
+
+// This is an asynchronous front end for parsing files.
+//
+// One I/O thread reads the submitted files in chunks of chunk_size bytes,
+// staying up to read_ahead chunks ahead of the parser threads. It keeps
+// reading the next chunks, and the next files, while the current chunks are
+// parsed, so the parser threads don't wait on I/O.
+// If the library is built with XMLPARSER_HAVE_LIBURING defined (and linked
+// with -luring), the reads are issued through io_uring and are all in
+// flight at once. Otherwise, or if io_uring is not available at run time,
+// the I/O thread reads them one after the other with pread(), handing each
+// chunk to the parser as soon as it is read.
+// Files that are not regular files (e.g. named pipes) have no size to read
+// ahead by. Their parser thread streams them straight from the fd.
+// submit() never blocks on opening a file. A named pipe is opened
+// non-blocking, and its parser thread waits for a writer.
+//
+// Files are parsed in the order they are submitted. Compressed files are
+// decompressed on the fly (see XMLmake_decompress_reader()).
+// A parsed document is delivered either through a std::future or through a
+// completion callback, which is called on a parser thread and must not
+// throw. A file that can't be read or an exception thrown during parsing is
+// delivered as an exception. A document with a fatal parse error is still
+// delivered, with the error in it.
+//
+// The destructor waits until all the submitted files are delivered.
+//
+class   XMLAsyncIngest  {
+
+    public:
+
+        typedef std::size_t                     size_type;
+        typedef std::unique_ptr<XMLDocument>    DocumentPtr;
+        typedef std::function<void (const std::string &file,
+                                    DocumentPtr doc,
+                                    std::exception_ptr error)>  Completion;
+
+        explicit XMLAsyncIngest (
+            size_type parser_threads = 1,
+            size_type chunk_size = 1024 * 1024,
+            size_type read_ahead = 8,
+            XERCES_CPP_NAMESPACE::SAXParser::ValSchemes vs =
+                XERCES_CPP_NAMESPACE::SAXParser::Val_Never);
+        ~XMLAsyncIngest ();
+
+        std::future<DocumentPtr> submit (const std::string &file);
+        void submit (const std::string &file, const Completion &completion);
+
+        inline bool uses_io_uring () const throw ()  { return (use_uring_); }
+
+    private:
+
+        class   Job_;
+
+       // A chunk_size buffer and the part of a file that is read into it
+       //
+        class   Chunk_  {
+
+            public:
+
+                explicit Chunk_ (size_type size) : buffer (new char [size])  {
+                }
+
+                std::unique_ptr<char []>    buffer;
+                Job_                        *job;
+                size_type                   index;
+                size_type                   length;
+                size_type                   done;
+                int                         error_no;
+        };
+
+        class   Job_  {
+
+            public:
+
+                std::string                 file;
+                Completion                  completion;
+                int                         fd;
+                int                         open_errno;
+                size_type                   file_size;
+                size_type                   num_chunks;
+                size_type                   next_issue;
+                size_type                   next_consume;
+                size_type                   consume_pos;
+                size_type                   outstanding;
+                bool                        streamed;
+                bool                        abandoned;
+                std::map<size_type, Chunk_ *>   ready;
+        };
+
+        typedef std::list<Job_> JobList;
+
+        const   size_type                   chunk_size_;
+        const   XERCES_CPP_NAMESPACE::SAXParser::ValSchemes vs_;
+        bool                                use_uring_;
+        bool                                stop_;
+
+        std::vector<std::unique_ptr<Chunk_> >   chunks_;
+        std::vector<Chunk_ *>                   free_chunks_;
+        size_type                               in_flight_;
+
+       // Jobs in submission order. The I/O thread reads ahead for them, and
+       // the parser threads take them from work_queue_ in the same order.
+       //
+        JobList                 jobs_;
+        std::deque<Job_ *>      work_queue_;
+
+        std::mutex              mutex_;
+        std::condition_variable io_cond_;
+        std::condition_variable data_cond_;
+        std::condition_variable work_cond_;
+
+        std::thread                 io_thread_;
+        std::vector<std::thread>    parser_threads_;
+
+#ifdef XMLPARSER_HAVE_LIBURING
+        void    *ring_;  // struct io_uring
+#endif // XMLPARSER_HAVE_LIBURING
+
+        Job_ *next_to_issue_ () throw ();
+        void complete_chunk_ (Chunk_ *chunk);
+        void read_chunk_ (Chunk_ &chunk) throw ();
+#ifdef XMLPARSER_HAVE_LIBURING
+        void submit_chunks_ (std::vector<Chunk_ *> &chunks);
+        int reap_chunks_ (std::vector<Chunk_ *> &chunks);
+        void fail_chunks_ (std::vector<Chunk_ *> &chunks, int error_no);
+#endif // XMLPARSER_HAVE_LIBURING
+
+        void io_loop_ ();
+        void parser_loop_ ();
+        void parse_job_ (Job_ &job,
+                         DocumentPtr &doc,
+                         std::exception_ptr &error);
+        static void wait_for_writer_ (const Job_ &job);
+        long read_job_ (Job_ &job, char *buffer, std::size_t max_size);
+        void finish_job_ (Job_ &job);
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLAsyncIngest (const XMLAsyncIngest &);
+        XMLAsyncIngest &operator = (const XMLAsyncIngest &);
+};
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLAsyncIngest_h
+#define _INCLUDED_XMLAsyncIngest_h 1
+#endif    // _INCLUDED_XMLAsyncIngest_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
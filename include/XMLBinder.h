@@ -0,0 +1,843 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLBinder_h
+#define _INCLUDED_XMLBinder_h 0
+
+// ----------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <XMLArenaMemoryManager.h>
+#include <XMLInputSources.h>
+#include <XMLString.h>
+#include <XMLTypedValue.h>
+#include <XMLXercesSupport.h>
+
+#include <xercesc/sax/AttributeList.hpp>
+#include <xercesc/sax/HandlerBase.hpp>
+#include <xercesc/parsers/SAXParser.hpp>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// Binding XML straight into C++ structs:
+//
+// A struct is mapped to an element once, by specializing XMLBinding. Its
+// members() lists the attributes and child elements that go into the
+// struct's data members:
+//
+//     struct  Field  { std::string tick_type; };
+//     struct  Symbol  {
+//         std::string         id;
+//         XMLTimeStamp        start;
+//         std::vector<Field>  fields;
+//     };
+//
+//     template<>
+//     struct  XMLBinding<Field>  {
+//         static constexpr auto members ()  {
+//             return (std::make_tuple (
+//                 XMLbind_attr ("TICK_TYPE", &Field::tick_type)));
+//         }
+//     };
+//     template<>
+//     struct  XMLBinding<Symbol>  {
+//         static constexpr const char *element = "SYMBOL";  // Root only
+//         static constexpr auto members ()  {
+//             return (std::make_tuple (
+//                 XMLbind_attr ("ID", &Symbol::id),
+//                 XMLbind_attr ("START", &Symbol::start),
+//                 XMLbind_children ("FIELD", &Symbol::fields)));
+//         }
+//     };
+//
+//     XMLBinder<Symbol>   binder;
+//     Symbol              symbol;
+//
+//     binder.parse_string (xml, xml_len, symbol);
+//
+// An attribute member may be std::string or anything XMLconvert() converts
+// to (integers, float, double, bool and XMLTimeStamp). A child element is
+// bound to a struct member (XMLbind_child()), or appended to a std::vector
+// of structs (XMLbind_children()). An attribute or child that may be left
+// out can be a std::optional of any of these, which tells whether it was
+// there.
+//
+// The parser fills the structs from its SAX events. No tree is built. The
+// dispatch on element and attribute names is generated at compile time: a
+// name is hashed once as it comes out of the parser, and only compared to
+// the names its parent element can have, as integers. The literal name is
+// checked only when the hash matches. The names in the bindings are UTF-8.
+//
+// Elements and attributes that are not bound are skipped, and so is a
+// second occurrence of a child that is bound to a single struct or
+// std::optional. In strict mode they are errors, and the bindings also
+// check the structure: an attribute or child bound as required must be
+// there by the time its element ends, and an attribute bound with a list
+// of values must have one of them:
+//
+//     static constexpr const char *sides [] = { "BUY", "SELL", NULL };
+//
+//     XMLbind_attr ("ID", &Symbol::id, true)             // Required
+//     XMLbind_attr ("SIDE", &Order::side, false, sides)  // One of sides
+//     XMLbind_children ("FIELD", &Symbol::fields, true)  // At least one
+//
+// A value that doesn't convert to its member's type is always an error.
+//
+// NOTE: A binder is not thread safe. Use one per thread, and reuse it for
+//       many documents.
+//
+template<typename T>
+struct  XMLBinding;
+
+// ----------------------------------------------------------------------------
+
+// FNV-1a hash of the UTF-8 bytes of an element or attribute name
+//
+typedef std::uint32_t   XMLNameHash;
+
+constexpr XMLNameHash XMLhash_name (const char *name) throw ()  {
+
+    XMLNameHash hash = 2166136261U;
+
+    for (; *name; ++name)
+        hash = (hash ^ static_cast<unsigned char>(*name)) * 16777619U;
+    return (hash);
+}
+
+// ----------------------------------------------------------------------------
+
+// values is a NULL terminated list of the values an attribute may have,
+// or NULL if it may have any. required and values are checked only in
+// strict mode.
+//
+template<typename C, typename M>
+struct  XMLAttrBinding  {
+
+    const   char        *name;
+    XMLNameHash         hash;
+    M C::*              member;
+    bool                required;
+    const   char *const *values;
+};
+
+template<typename C, typename M>
+struct  XMLChildBinding  {
+
+    const   char        *name;
+    XMLNameHash         hash;
+    M C::*              member;
+    bool                required;  // At least one, if it is a vector
+};
+
+template<typename C, typename M>
+constexpr XMLAttrBinding<C, M>
+XMLbind_attr (const char *name,
+              M C::*member,
+              bool required = false,
+              const char *const *values = NULL) throw ()  {
+
+    return (XMLAttrBinding<C, M>
+                { name, XMLhash_name (name), member, required, values });
+}
+
+template<typename C, typename M>
+constexpr XMLChildBinding<C, M>
+XMLbind_child (const char *name,
+               M C::*member,
+               bool required = false) throw ()  {
+
+    return (XMLChildBinding<C, M>
+                { name, XMLhash_name (name), member, required });
+}
+
+template<typename C, typename M>
+constexpr XMLChildBinding<C, std::vector<M> >
+XMLbind_children (const char *name,
+                  std::vector<M> C::*member,
+                  bool required = false) throw ()  {
+
+    return (XMLChildBinding<C, std::vector<M> >
+                { name, XMLhash_name (name), member, required });
+}
+
+// ----------------------------------------------------------------------------
+
+// The part of the binder that doesn't depend on the bound type. It drives
+// the SAX parser and keeps the stack of structs being filled.
+//
+class   XMLBinderBase : public XERCES_CPP_NAMESPACE::HandlerBase  {
+
+    private:
+
+        typedef XERCES_CPP_NAMESPACE::SAXParser         SAXParser;
+        typedef XERCES_CPP_NAMESPACE::SAXParseException SAXParseException;
+        typedef XERCES_CPP_NAMESPACE::AttributeList     AttributeList;
+
+    public:
+
+        typedef unsigned int    size_type;
+
+        inline void set_strict (bool on) throw ()  { strict_ = on; }
+        inline bool is_strict () const throw ()  { return (strict_); }
+
+        inline bool has_fatal_error () const throw ()  {
+
+            return (has_problem_);
+        }
+        inline const std::string &fatal_error () const throw ()  {
+
+            return (fatal_error_);
+        }
+
+    protected:
+
+        XMLBinderBase (SAXParser::ValSchemes vs, bool strict);
+        ~XMLBinderBase () throw ();
+
+       // An element name as it comes out of the parser, and its hash
+       //
+        class   Name_  {
+
+            public:
+
+                const   XMLCh   *name;
+                XMLNameHash     hash;
+        };
+
+       // A bit per member of a struct, in the order of its bindings. It
+       // tells which attributes and children of an element were seen.
+       //
+        typedef std::uint64_t   SeenMask_;
+
+       // Called with the struct at the top of the stack, when one of its
+       // child elements starts. It returns false, if the child is not bound.
+       //
+        typedef bool (*StartChild_) (XMLBinderBase &binder,
+                                     void *object,
+                                     SeenMask_ &seen,
+                                     const Name_ &name,
+                                     AttributeList &attributes);
+
+       // Called with what was seen of the struct at the top of the stack,
+       // when its element ends in strict mode
+       //
+        typedef void (*EndElement_) (XMLBinderBase &binder,
+                                     SeenMask_ seen,
+                                     const XMLCh *const name);
+
+       // These are called by the typed parse methods of XMLBinder
+       //
+        template<typename T>
+        void begin_ (T &object);
+        bool parse_string_ (const char *const xml,
+                            std::size_t xml_len,
+                            const char *const sys_id);
+        bool parse_file_ (const char *const file);
+        bool parse_callback_ (const XMLReadCallback &read_cb,
+                              const char *const sys_id);
+
+       // SAX DocumentHandler interface
+       //
+        void startElement (const XMLCh *const name,
+                           AttributeList &attributes) throw ();
+        void endElement (const XMLCh *const name) throw ();
+
+       // SAX ErrorHandler interface
+       //
+        void error (const SAXParseException &exception) throw ();
+        void fatalError (const SAXParseException &exception) throw ();
+
+    private:
+
+        class   Frame_  {
+
+            public:
+
+                void        *object;
+                StartChild_ start_child;
+                EndElement_ end_element;
+                SeenMask_   seen;
+        };
+
+       // Xerces is initialized before anything else in here is constructed,
+       // and terminated after everything else is destroyed.
+       //
+        XMLXercesInitializer                        init_;
+        std::unique_ptr<XMLArenaMemoryManager>      mem_manager_;
+        std::unique_ptr<SAXParser>                  parser_;
+        XMLMemBufInputSource                        mem_buf_;
+
+        bool                    strict_;
+        bool                    has_problem_;
+        bool                    root_seen_;
+        size_type               skip_depth_;
+        std::vector<Frame_>     frames_;
+        std::string             value_;
+        std::string             fatal_error_;
+
+        void start_ (void *object, StartChild_ start_root);
+        bool parse_ (const XERCES_CPP_NAMESPACE::InputSource *source,
+                     const char *const file);
+
+       // Reports a binding error. Everything after it is ignored.
+       //
+        void fail_ (const char *what,
+                    const XMLCh *const name,
+                    const char *value = "");
+        void fail_ (const char *what,
+                    const char *name,
+                    const XMLCh *const element);
+
+       // The attribute value in value_, narrowed to chars
+       //
+        const char *narrow_value_ (const XMLCh *const value);
+
+       // The names in the bindings are UTF-8 and the parser's are UTF-16.
+       // A parser name is hashed and compared by its UTF-8 bytes, which
+       // are made one character at a time.
+       // It returns the number of bytes, and advances name past the char.
+       //
+        static unsigned
+        utf8_char_ (const XMLCh *&name, unsigned char *bytes) throw ()  {
+
+            unsigned long   code = *name++;
+
+            if (code < 0x80)  {
+                bytes [0] = static_cast<unsigned char>(code);
+                return (1);
+            }
+            if (code < 0x800)  {
+                bytes [0] = static_cast<unsigned char>(0xC0 | (code >> 6));
+                bytes [1] = static_cast<unsigned char>(0x80 | (code & 0x3F));
+                return (2);
+            }
+            if (code >= 0xD800 && code < 0xDC00 &&
+                *name >= 0xDC00 && *name < 0xE000)  {  // Surrogate pair
+                code = 0x10000 + ((code - 0xD800) << 10) + (*name++ - 0xDC00);
+                bytes [0] = static_cast<unsigned char>(0xF0 | (code >> 18));
+                bytes [1] =
+                    static_cast<unsigned char>(0x80 | ((code >> 12) & 0x3F));
+                bytes [2] =
+                    static_cast<unsigned char>(0x80 | ((code >> 6) & 0x3F));
+                bytes [3] = static_cast<unsigned char>(0x80 | (code & 0x3F));
+                return (4);
+            }
+            bytes [0] = static_cast<unsigned char>(0xE0 | (code >> 12));
+            bytes [1] =
+                static_cast<unsigned char>(0x80 | ((code >> 6) & 0x3F));
+            bytes [2] = static_cast<unsigned char>(0x80 | (code & 0x3F));
+            return (3);
+        }
+
+        static XMLNameHash hash_name_ (const XMLCh *name) throw ()  {
+
+            XMLNameHash     hash = 2166136261U;
+            unsigned char   bytes [4];
+
+            while (*name)  {
+                const   unsigned    len = utf8_char_ (name, bytes);
+
+                for (unsigned i = 0; i < len; ++i)
+                    hash = (hash ^ bytes [i]) * 16777619U;
+            }
+            return (hash);
+        }
+
+       // Only called when the hashes are equal
+       //
+        static bool
+        same_name_ (const XMLCh *name, const char *literal) throw ()  {
+
+            unsigned char   bytes [4];
+
+            while (*name)  {
+                const   unsigned    len = utf8_char_ (name, bytes);
+
+                for (unsigned i = 0; i < len; ++i, ++literal)
+                    if (static_cast<unsigned char>(*literal) != bytes [i])
+                        return (false);
+            }
+            return (*literal == 0);
+        }
+
+       // The generated dispatch:
+       //
+       // All of these are instantiated per bound struct. The fold
+       // expressions over the members of a struct expand to a sequence of
+       // integer compares of the hashes.
+       //
+        template<typename T>
+        static constexpr auto   bindings_ = XMLBinding<T>::members ();
+
+       // The members are numbered, as the folds go over them, by their bit
+       // in a SeenMask_.
+       //
+        template<typename T>
+        static bool start_root_ (XMLBinderBase &binder,
+                                 void *object,
+                                 SeenMask_ &seen,
+                                 const Name_ &name,
+                                 AttributeList &attributes);
+        template<typename T>
+        static bool start_child_ (XMLBinderBase &binder,
+                                  void *object,
+                                  SeenMask_ &seen,
+                                  const Name_ &name,
+                                  AttributeList &attributes);
+        template<typename T>
+        static void end_element_ (XMLBinderBase &binder,
+                                  SeenMask_ seen,
+                                  const XMLCh *const name);
+        template<typename T>
+        static void enter_ (XMLBinderBase &binder,
+                            T &object,
+                            AttributeList &attributes);
+
+        template<typename C, typename M>
+        static bool
+        try_attr_ (XMLBinderBase &binder,
+                   C &object,
+                   const XMLAttrBinding<C, M> &binding,
+                   SeenMask_ bit,
+                   SeenMask_ &seen,
+                   XMLNameHash hash,
+                   const XMLCh *const name,
+                   const XMLCh *const value);
+        template<typename C, typename M>
+        static inline bool
+        try_attr_ (XMLBinderBase &,
+                   C &,
+                   const XMLChildBinding<C, M> &,
+                   SeenMask_,
+                   SeenMask_ &,
+                   XMLNameHash,
+                   const XMLCh *const,
+                   const XMLCh *const) throw ()  { return (false); }
+
+        template<typename C, typename M>
+        static bool
+        try_child_ (XMLBinderBase &binder,
+                    C &object,
+                    const XMLChildBinding<C, M> &binding,
+                    SeenMask_ bit,
+                    SeenMask_ &seen,
+                    const Name_ &name,
+                    AttributeList &attributes);
+        template<typename C, typename M>
+        static inline bool
+        try_child_ (XMLBinderBase &,
+                    C &,
+                    const XMLAttrBinding<C, M> &,
+                    SeenMask_,
+                    SeenMask_ &,
+                    const Name_ &,
+                    AttributeList &) throw ()  { return (false); }
+
+       // Fails the parse, if a required member was not seen
+       //
+        template<typename C, typename M>
+        static inline void
+        check_seen_ (XMLBinderBase &binder,
+                     const XMLAttrBinding<C, M> &binding,
+                     SeenMask_ bit,
+                     SeenMask_ seen,
+                     const XMLCh *const name)  {
+
+            if (binding.required && ! (seen & bit))
+                binder.fail_ ("missing attribute", binding.name, name);
+        }
+        template<typename C, typename M>
+        static inline void
+        check_seen_ (XMLBinderBase &binder,
+                     const XMLChildBinding<C, M> &binding,
+                     SeenMask_ bit,
+                     SeenMask_ seen,
+                     const XMLCh *const name)  {
+
+            if (binding.required && ! (seen & bit))
+                binder.fail_ ("missing element", binding.name, name);
+        }
+
+        static bool
+        is_listed_ (const char *value, const char *const *values) throw ();
+
+       // A child bound to a vector may occur any number of times. Anything
+       // else only once.
+       //
+        template<typename M>
+        static constexpr bool repeats_ (const M *) throw ()  {
+
+            return (false);
+        }
+        template<typename M>
+        static constexpr bool repeats_ (const std::vector<M> *) throw ()  {
+
+            return (true);
+        }
+
+       // Where a child element goes: the member itself, or a new element
+       // of the vector
+       //
+        template<typename M>
+        static inline M &child_slot_ (M &member)  { return (member); }
+        template<typename M>
+        static inline M &child_slot_ (std::vector<M> &member)  {
+
+            member.emplace_back ();
+            return (member.back ());
+        }
+        template<typename M>
+        static inline M &child_slot_ (std::optional<M> &member)  {
+
+            member.emplace ();
+            return (*member);
+        }
+
+        static inline bool
+        assign_ (std::string &member, const char *value)  {
+
+            member = value;
+            return (true);
+        }
+        template<typename M>
+        static inline bool assign_ (M &member, const char *value) throw ()  {
+
+            return (XMLconvert (value, member) == xcs_ok);
+        }
+        template<typename M>
+        static inline bool
+        assign_ (std::optional<M> &member, const char *value)  {
+
+            M   converted = M ();
+
+            if (! assign_ (converted, value))
+                return (false);
+            member = std::move (converted);
+            return (true);
+        }
+
+       // Brings the structs back to their default state before a parse.
+       // Strings and vectors keep their capacity.
+       //
+        template<typename T>
+        static void reset_ (T &object);
+        template<typename C, typename M>
+        static void reset_member_ (C &object,
+                                   const XMLAttrBinding<C, M> &binding);
+        template<typename C, typename M>
+        static void reset_member_ (C &object,
+                                   const XMLChildBinding<C, M> &binding);
+        static inline void reset_value_ (std::string &member) throw ()  {
+
+            member.clear ();
+        }
+        template<typename M>
+        static inline void reset_value_ (std::vector<M> &member) throw ()  {
+
+            member.clear ();
+        }
+        template<typename M>
+        static inline void reset_value_ (std::optional<M> &member) throw ()  {
+
+            member.reset ();
+        }
+        template<typename M>
+        static inline void reset_value_ (M &member)  {
+
+            if constexpr (std::is_class<M>::value &&
+                          ! std::is_same<M, XMLTimeStamp>::value)
+                reset_ (member);
+            else
+                member = M ();
+        }
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLBinderBase (const XMLBinderBase &);
+        XMLBinderBase &operator = (const XMLBinderBase &);
+};
+
+// ----------------------------------------------------------------------------
+
+// Binds documents whose root element is XMLBinding<T>::element into T
+//
+// The parse methods first bring object back to its default state. They
+// return false, if the document couldn't be parsed or bound, or its root
+// element is not the expected one (see fatal_error()).
+// parse_stream() and parse_fd() decompress gzip and zstd input on the fly
+// (see XMLmake_decompress_reader()).
+//
+template<typename T>
+class   XMLBinder : public XMLBinderBase  {
+
+    public:
+
+        explicit XMLBinder (XERCES_CPP_NAMESPACE::SAXParser::ValSchemes vs =
+                                XERCES_CPP_NAMESPACE::SAXParser::Val_Never,
+                            bool strict = false)
+            : XMLBinderBase (vs, strict)  {   }
+
+        inline bool parse_string (const char *const xml,
+                                  std::size_t xml_len,
+                                  T &object,
+                                  const char *const sys_id = "default")  {
+
+            begin_ (object);
+            return (parse_string_ (xml, xml_len, sys_id));
+        }
+        inline bool parse_file (const char *const file, T &object)  {
+
+            begin_ (object);
+            return (parse_file_ (file));
+        }
+        inline bool parse_callback (const XMLReadCallback &read_cb,
+                                    T &object,
+                                    const char *const sys_id = "callback")  {
+
+            begin_ (object);
+            return (parse_callback_ (read_cb, sys_id));
+        }
+        inline bool parse_stream (std::istream &is,
+                                  T &object,
+                                  const char *const sys_id = "stream")  {
+
+            return (parse_callback (
+                        XMLmake_decompress_reader (XMLmake_stream_reader (is)),
+                        object,
+                        sys_id));
+        }
+        inline bool parse_fd (int fd,
+                              T &object,
+                              const char *const sys_id = "fd")  {
+
+            return (parse_callback (
+                        XMLmake_decompress_reader (XMLmake_fd_reader (fd)),
+                        object,
+                        sys_id));
+        }
+};
+
+// ----------------------------------------------------------------------------
+
+template<typename T>
+void XMLBinderBase::begin_ (T &object)  {
+
+    reset_ (object);
+    start_ (&object, &start_root_<T>);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<typename T>
+bool XMLBinderBase::start_root_ (XMLBinderBase &binder,
+                                 void *object,
+                                 SeenMask_ &,
+                                 const Name_ &name,
+                                 AttributeList &attributes)  {
+
+    constexpr   XMLNameHash hash = XMLhash_name (XMLBinding<T>::element);
+
+    if (binder.root_seen_ || name.hash != hash ||
+        ! same_name_ (name.name, XMLBinding<T>::element))  {
+        binder.fail_ ("unexpected root element", name.name);
+        return (true);
+    }
+
+    binder.root_seen_ = true;
+    enter_ (binder, *static_cast<T *>(object), attributes);
+    return (true);
+}
+
+// ----------------------------------------------------------------------------
+
+template<typename T>
+bool XMLBinderBase::start_child_ (XMLBinderBase &binder,
+                                  void *object,
+                                  SeenMask_ &seen,
+                                  const Name_ &name,
+                                  AttributeList &attributes)  {
+
+    T           &obj = *static_cast<T *>(object);
+    SeenMask_   bit = 1;
+
+    return (std::apply (
+        [&] (const auto &... binding) -> bool  {
+            return (((try_child_ (binder, obj, binding, bit, seen,
+                                  name, attributes) ||
+                      (bit <<= 1, false)) || ...));
+        },
+        bindings_<T>));
+}
+
+// ----------------------------------------------------------------------------
+
+template<typename T>
+void XMLBinderBase::end_element_ (XMLBinderBase &binder,
+                                  SeenMask_ seen,
+                                  const XMLCh *const name)  {
+
+    SeenMask_   bit = 1;
+
+    std::apply (
+        [&] (const auto &... binding)  {
+            ((check_seen_ (binder, binding, bit, seen, name), bit <<= 1),
+             ...);
+        },
+        bindings_<T>);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Binds the attributes and makes object the top of the stack
+//
+template<typename T>
+void XMLBinderBase::enter_ (XMLBinderBase &binder,
+                            T &object,
+                            AttributeList &attributes)  {
+
+    static_assert (std::tuple_size<decltype (bindings_<T>)>::value <=
+                       sizeof (SeenMask_) * 8,
+                   "Too many members are bound to one struct");
+
+    const   size_type   attr_size = attributes.getLength ();
+    SeenMask_           seen = 0;
+
+    for (size_type i = 0; i < attr_size && ! binder.has_problem_; ++i)  {
+        const   XMLCh *const    name = attributes.getName (i);
+        const   XMLCh *const    value = attributes.getValue (i);
+        const   XMLNameHash     hash = hash_name_ (name);
+        SeenMask_               bit = 1;
+        const   bool            bound = std::apply (
+            [&] (const auto &... binding) -> bool  {
+                return (((try_attr_ (binder, object, binding, bit, seen,
+                                     hash, name, value) ||
+                          (bit <<= 1, false)) || ...));
+            },
+            bindings_<T>);
+
+        if (! bound && binder.strict_)
+            binder.fail_ ("unexpected attribute", name);
+    }
+
+    binder.frames_.push_back (
+        Frame_ { &object, &start_child_<T>, &end_element_<T>, seen });
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<typename C, typename M>
+bool XMLBinderBase::try_attr_ (XMLBinderBase &binder,
+                               C &object,
+                               const XMLAttrBinding<C, M> &binding,
+                               SeenMask_ bit,
+                               SeenMask_ &seen,
+                               XMLNameHash hash,
+                               const XMLCh *const name,
+                               const XMLCh *const value)  {
+
+    if (hash != binding.hash || ! same_name_ (name, binding.name))
+        return (false);
+
+    const   char    *str = binder.narrow_value_ (value);
+
+    seen |= bit;
+    if ((binder.strict_ && binding.values != NULL &&
+         ! is_listed_ (str, binding.values)) ||
+        ! assign_ (object.*(binding.member), str))
+        binder.fail_ ("invalid value of attribute", name, str);
+    return (true);
+}
+
+// ----------------------------------------------------------------------------
+
+template<typename C, typename M>
+bool XMLBinderBase::try_child_ (XMLBinderBase &binder,
+                                C &object,
+                                const XMLChildBinding<C, M> &binding,
+                                SeenMask_ bit,
+                                SeenMask_ &seen,
+                                const Name_ &name,
+                                AttributeList &attributes)  {
+
+    if (name.hash != binding.hash || ! same_name_ (name.name, binding.name))
+        return (false);
+
+   // seen is in the parent's frame, which enter_() may move. So it is
+   // updated first.
+   //
+    if ((seen & bit) && ! repeats_ (&(object.*(binding.member))))  {
+        if (binder.strict_)
+            binder.fail_ ("repeated element", name.name);
+        else
+            binder.skip_depth_ = 1;
+        return (true);
+    }
+    seen |= bit;
+
+    enter_ (binder, child_slot_ (object.*(binding.member)), attributes);
+    return (true);
+}
+
+// ----------------------------------------------------------------------------
+
+template<typename T>
+void XMLBinderBase::reset_ (T &object)  {
+
+    std::apply (
+        [&] (const auto &... binding)  {
+            (reset_member_ (object, binding), ...);
+        },
+        bindings_<T>);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<typename C, typename M>
+void XMLBinderBase::reset_member_ (C &object,
+                                   const XMLAttrBinding<C, M> &binding)  {
+
+    reset_value_ (object.*(binding.member));
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<typename C, typename M>
+void XMLBinderBase::reset_member_ (C &object,
+                                   const XMLChildBinding<C, M> &binding)  {
+
+    reset_value_ (object.*(binding.member));
+    return;
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLBinder_h
+#define _INCLUDED_XMLBinder_h 1
+#endif    // _INCLUDED_XMLBinder_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,249 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLBufferedWriter_h
+#define _INCLUDED_XMLBufferedWriter_h 0
+
+// ----------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <XMLWriter.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// These are the targets that XMLBufferedWriter flushes its buffer to.
+// A target only needs a write (const char *data, std::size_t len) method,
+// which is called with whole blocks, not single tokens.
+//
+
+// Appends to a std::string
+//
+class   XMLStringSink  {
+
+    public:
+
+        explicit XMLStringSink (std::string &str) throw () : str_ (str)  {   }
+
+        inline void write (const char *data, std::size_t len)  {
+
+            str_.append (data, len);
+            return;
+        }
+
+    private:
+
+        std::string &str_;
+};
+
+// Fills a fixed size buffer. It throws std::runtime_error, if the buffer
+// would overflow.
+//
+class   XMLFixedSink  {
+
+    public:
+
+        XMLFixedSink (char *buffer, std::size_t capacity) throw ()
+            : buffer_ (buffer), capacity_ (capacity), size_ (0)  {   }
+
+        inline void write (const char *data, std::size_t len)  {
+
+            if (len > capacity_ - size_)
+                overflow_ (len);
+            ::memcpy (buffer_ + size_, data, len);
+            size_ += len;
+            return;
+        }
+
+        inline std::size_t size () const throw ()  { return (size_); }
+        inline void clear () throw ()  { size_ = 0; }
+
+    private:
+
+        char        *buffer_;
+        std::size_t capacity_;
+        std::size_t size_;
+
+        void overflow_ (std::size_t len) const;
+};
+
+// Writes to a file descriptor, retrying partial writes. If the fd is
+// non-blocking, it waits with poll() for it to be writable. It throws
+// std::runtime_error, if write() fails.
+//
+class   XMLFdSink  {
+
+    public:
+
+        explicit XMLFdSink (int fd) throw () : fd_ (fd)  {   }
+
+        void write (const char *data, std::size_t len);
+
+    private:
+
+        const   int fd_;
+};
+
+// Writes to anything that has a std::ostream like write() method
+//
+template <class xml_STREAM>
+class   XMLOStreamSink  {
+
+    public:
+
+        explicit XMLOStreamSink (xml_STREAM &os) throw () : os_ (os)  {   }
+
+        inline void write (const char *data, std::size_t len)  {
+
+            os_.write (data, len);
+            return;
+        }
+
+    private:
+
+        xml_STREAM  &os_;
+};
+
+// ----------------------------------------------------------------------------
+
+// This produces exactly what XMLStreamWriter produces, with the same
+// methods, but without a virtual call and an ostream insertion for every
+// token. The target is a template parameter, so every write is resolved at
+// compile time. The tokens are gathered in a block buffer, which is handed
+// to the target only when it is full and by flush(). Indentation is copied
+// out of a table, instead of written three spaces at a time.
+// The names of the open elements are kept, one after the other, in one
+// string that is reused for every element.
+//
+//     std::string                         out;
+//     XMLStringSink                       sink (out);
+//     XMLBufferedWriter<XMLStringSink>    writer (sink);
+//
+//     writer.write_open_tag ("DATA_REQUEST");
+//     writer.write_attribute ("TYPE", "ticks");
+//     writer.write_close_tag ();
+//     writer.flush ();
+//
+// NOTE: The destructor flushes too, but it has to ignore errors. Call
+//       flush() to see them.
+//
+template <class xml_SINK>
+class   XMLBufferedWriter  {
+
+    public:
+
+        typedef unsigned int    size_type;
+
+        explicit XMLBufferedWriter (xml_SINK &sink,
+                                    size_type block_size = 16 * 1024);
+        ~XMLBufferedWriter () throw ();
+
+        void write_open_tag (const char *name);
+        void write_close_tag ();
+
+        void write_attribute (const char *name, const char *value,
+                              bool encode_content = true);
+        void write_content (const char *content);
+        void write_cdata (const char *cdata);
+        void write_comment (const char *const comment);
+
+       // Hands the buffered output to the target
+       //
+        inline void flush ()  {
+
+            if (used_ > 0)  {
+                const   size_type   used = used_;
+
+                used_ = 0;
+                sink_.write (&(buffer_ [0]), used);
+            }
+            return;
+        }
+
+        inline xml_SINK &get_sink () throw ()  { return (sink_); }
+        inline size_type depth () const throw ()  { return (stack_.size ()); }
+
+        bool    needs_indent;
+
+    private:
+
+        enum State  { es_tagSet, es_contentSet };
+
+       // An open element. Its name is at name_offset in names_.
+       //
+        class   Frame_  {
+
+            public:
+
+                size_type   name_offset;
+                size_type   name_len;
+                State       state;
+        };
+
+        xml_SINK            &sink_;
+        std::vector<char>   buffer_;
+        size_type           used_;
+        std::vector<Frame_> stack_;
+        std::string         names_;
+        std::string         literal_;
+
+        inline void put_ (const char *str, size_type len)  {
+
+            if (len <= buffer_.size () - used_)  {
+                ::memcpy (&(buffer_ [0]) + used_, str, len);
+                used_ += len;
+            }
+            else
+                put_long_ (str, len);
+            return;
+        }
+        inline void put_ (const char *str)  { put_ (str, ::strlen (str)); }
+
+        void put_long_ (const char *str, size_type len);
+        void indent_ (size_type level);
+
+        inline Frame_ &current_ (const char *caller)  {
+
+            if (stack_.empty ())
+                no_current_tag_ (caller);
+            return (stack_.back ());
+        }
+
+        static void no_current_tag_ (const char *caller);
+        static void bad_state_ (const char *caller);
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLBufferedWriter ();
+        XMLBufferedWriter (const XMLBufferedWriter &);
+        XMLBufferedWriter &operator = (const XMLBufferedWriter &);
+};
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#  ifdef DMS_INCLUDE_SOURCE
+#    include <XMLBufferedWriter.tcc>
+#  endif // DMS_INCLUDE_SOURCE
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLBufferedWriter_h
+#define _INCLUDED_XMLBufferedWriter_h 1
+#endif    // _INCLUDED_XMLBufferedWriter_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,232 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <stdexcept>
+
+#include <DMScu_FixedSizeString.h>
+
+#include <XMLBufferedWriter.h>
+#include <XMLEscape.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+template <class xml_SINK>
+XMLBufferedWriter<xml_SINK>::
+XMLBufferedWriter (xml_SINK &sink, size_type block_size)
+    : needs_indent (true),
+      sink_ (sink),
+      buffer_ (block_size > 0 ? block_size : 1),
+      used_ (0)  {
+
+    stack_.reserve (32);
+}
+
+// ----------------------------------------------------------------------------
+
+template <class xml_SINK>
+XMLBufferedWriter<xml_SINK>::~XMLBufferedWriter () throw ()  {
+
+    try  {
+        flush ();
+    }
+    catch (...)  {
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// What doesn't fit in the buffer anymore. If it is at least as big as the
+// whole buffer, it goes to the target directly, after what is buffered.
+//
+template <class xml_SINK>
+void XMLBufferedWriter<xml_SINK>::put_long_ (const char *str, size_type len)  {
+
+    flush ();
+    if (len >= buffer_.size ())
+        sink_.write (str, len);
+    else  {
+        ::memcpy (&(buffer_ [0]), str, len);
+        used_ = len;
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// A new line and three spaces per level
+//
+template <class xml_SINK>
+void XMLBufferedWriter<xml_SINK>::indent_ (size_type level)  {
+
+    static  const   char        table [] =
+        "\n                                "
+        "                                "
+        "                                ";
+    static  const   size_type   max_level = (sizeof (table) - 2) / 3;
+
+    if (! needs_indent)
+        return;
+
+    if (level <= max_level)
+        put_ (table, 1 + level * 3);
+    else  {
+        put_ (table, 1 + max_level * 3);
+        for (level -= max_level; level > max_level; level -= max_level)
+            put_ (table + 1, max_level * 3);
+        put_ (table + 1, level * 3);
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template <class xml_SINK>
+void XMLBufferedWriter<xml_SINK>::no_current_tag_ (const char *caller)  {
+
+    DMScu_FixedSizeString<1023> err;
+
+    err.printf ("XMLBufferedWriter::%s(): Cannot write: no current tag",
+                caller);
+    throw std::runtime_error (err.c_str ());
+}
+
+// ----------------------------------------------------------------------------
+
+template <class xml_SINK>
+void XMLBufferedWriter<xml_SINK>::bad_state_ (const char *caller)  {
+
+    DMScu_FixedSizeString<1023> err;
+
+    err.printf ("XMLBufferedWriter::%s(): Cannot write; element state ",
+                caller);
+    throw std::runtime_error (err.c_str ());
+}
+
+// ----------------------------------------------------------------------------
+
+template <class xml_SINK>
+void XMLBufferedWriter<xml_SINK>::write_open_tag (const char *name)  {
+
+    if (! stack_.empty ())  {
+        Frame_  &parent = stack_.back ();
+
+        if (parent.state == es_tagSet)
+            put_ (">", 1);
+        indent_ (size_type (stack_.size ()));
+        parent.state = es_contentSet;
+    }
+
+    const   size_type   len = size_type (::strlen (name));
+
+    put_ ("<", 1);
+    put_ (name, len);
+    stack_.push_back (Frame_ { size_type (names_.size ()), len, es_tagSet });
+    names_.append (name, len);
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template <class xml_SINK>
+void XMLBufferedWriter<xml_SINK>::write_close_tag ()  {
+
+    const   Frame_  &e = current_ ("write_close_tag");
+
+    if (e.state == es_tagSet)
+        put_ ("/>", 2);
+    else  {
+        indent_ (size_type (stack_.size () - 1));
+        put_ ("</", 2);
+        put_ (names_.data () + e.name_offset, e.name_len);
+        put_ (">", 1);
+    }
+
+    names_.resize (e.name_offset);
+    stack_.pop_back ();
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template <class xml_SINK>
+void XMLBufferedWriter<xml_SINK>::
+write_attribute (const char *name, const char *value, bool encode_content) {
+
+    if (current_ ("write_attribute").state != es_tagSet)
+        bad_state_ ("write_attribute");
+
+    put_ (" ", 1);
+    put_ (name);
+    put_ ("=\"", 2);
+    if (encode_content)
+        XMLencode_literal (value, ::strlen (value),
+                           [this] (const char *run, std::size_t len)  {
+                               put_ (run, size_type (len));
+                           });
+    else
+        put_ (value);
+    put_ ("\"", 1);
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template <class xml_SINK>
+void XMLBufferedWriter<xml_SINK>::write_content (const char *content)  {
+
+    Frame_  &e = current_ ("write_content");
+
+    if (e.state != es_tagSet)
+        bad_state_ ("write_content");
+
+    e.state = es_contentSet;
+    put_ (content);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template <class xml_SINK>
+void XMLBufferedWriter<xml_SINK>::write_cdata (const char *cdata)  {
+
+    Frame_  &e = current_ ("write_cdata");
+
+    if (e.state != es_tagSet)
+        bad_state_ ("write_cdata");
+
+    e.state = es_contentSet;
+    put_ ("<", 1);
+    put_ (cdata);
+    put_ (">", 1);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template <class xml_SINK>
+void XMLBufferedWriter<xml_SINK>::write_comment (const char *const comment)  {
+
+    XMLWriter::encode_comment (comment, literal_);
+    indent_ (size_type (stack_.size ()));
+    put_ (literal_.data (), size_type (literal_.size ()));
+    return;
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,249 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLCursor_h
+#define _INCLUDED_XMLCursor_h 0
+
+// ----------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <XMLArenaMemoryManager.h>
+#include <XMLInputSources.h>
+#include <XMLNVPair.h>
+#include <XMLTypedValue.h>
+#include <XMLXercesSupport.h>
+
+#include <xercesc/sax/HandlerBase.hpp>
+#include <xercesc/parsers/SAXParser.hpp>
+#include <xercesc/framework/XMLPScanToken.hpp>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// This is a pull parser. Instead of building a tree, it walks the document
+// one element at a time, as the caller asks for it:
+//
+//     XMLCursor   cursor;
+//
+//     cursor.open_string (xml, xml_len);
+//     while (cursor.next () != XMLCursor::ce_end_document)
+//         if (cursor.event () == XMLCursor::ce_start_element)  {
+//             if (! ::strcmp (cursor.name (), "FIELD"))
+//                 use (cursor.attr ("TICK_TYPE"));
+//             else if (! ::strcmp (cursor.name (), "NOT_NEEDED"))
+//                 cursor.skip_subtree ();
+//         }
+//
+// The document is scanned progressively, only as far as needed to deliver
+// the next event. skip_subtree() scans past the rest of the current element
+// without copying anything out of it.
+// The name and attributes of the current element live in buffers that are
+// reused from one element, and one document, to the next. They are valid
+// until the next call to next() or skip_subtree().
+//
+// Only elements are reported. Character data, comments and processing
+// instructions are scanned past.
+//
+// NOTE: A cursor is not thread safe. Use one per thread, and reuse it for
+//       many documents.
+//
+class   XMLCursor : public XERCES_CPP_NAMESPACE::HandlerBase  {
+
+    private:
+
+        typedef XERCES_CPP_NAMESPACE::SAXParser         SAXParser;
+        typedef XERCES_CPP_NAMESPACE::SAXParseException SAXParseException;
+        typedef XERCES_CPP_NAMESPACE::AttributeList     AttributeList;
+
+        typedef std::vector<XMLNVPair>  AttrVector;
+
+    public:
+
+        typedef unsigned int                    size_type;
+        typedef AttrVector::const_iterator      attr_const_iterator;
+        typedef std::vector<std::string>        XmlErrorVector;
+
+        enum Event  {
+            ce_start_element = 0,
+            ce_end_element = 1,
+            ce_end_document = 2
+        };
+
+        XMLCursor (SAXParser::ValSchemes vs = SAXParser::Val_Never,
+                   bool do_namespace = false);
+        ~XMLCursor () throw ();
+
+       // These start a new document. Whatever was left of the previous one
+       // is discarded. They return false, if the document couldn't be
+       // started (see fatal_error()).
+       // The input must stay alive and unchanged until the document is
+       // done. open_stream() and open_fd() decompress gzip and zstd input
+       // on the fly (see XMLmake_decompress_reader()).
+       //
+        bool open_string (const char *const xml,
+                          std::size_t xml_len,
+                          const char *const sys_id = "default");
+        bool open_file (const char *const file);
+        bool open_stream (std::istream &is,
+                          const char *const sys_id = "stream");
+        bool open_fd (int fd, const char *const sys_id = "fd");
+        bool open_callback (const XMLReadCallback &read_cb,
+                            const char *const sys_id = "callback");
+
+       // Discards the rest of the current document
+       //
+        void close ();
+
+       // Advances to the next start or end of an element. It returns
+       // ce_end_document at the end of the document, or if there was a
+       // fatal error. Warnings and (validation) errors are recorded, and
+       // the document goes on.
+       //
+        Event next ();
+
+       // At the start of an element, it scans past all of its content and
+       // stops at its end, so the next call to next() goes to what follows
+       // the element. Nothing inside the element is copied or reported.
+       // It returns false, if the cursor is not at the start of an element,
+       // or the document ended early.
+       //
+        bool skip_subtree ();
+
+        inline Event event () const throw ()  { return (event_); }
+
+       // The depth of the current element. The root element is at depth 1.
+       //
+        inline size_type depth () const throw ()  { return (depth_); }
+
+       // The name of the current element
+       //
+        inline const char *name () const throw ()  { return (name_.c_str ()); }
+
+       // The attributes of the current element. There are attributes only at
+       // the start of an element. attr() returns NULL, if there is no
+       // attribute called name.
+       //
+        const char *attr (const char *const name) const throw ();
+
+       // Converts the value of the attribute to T (see XMLTypedValue.h).
+       // value is left alone, unless it returns xcs_ok.
+       //
+        template<typename T>
+        inline XMLConvStatus
+        attr_as (const char *const name, T &value) const throw ()  {
+
+            return (XMLconvert (attr (name), value));
+        }
+
+        inline size_type attr_count () const throw ()  { return (attr_count_); }
+        inline attr_const_iterator attr_begin () const throw ()  {
+
+            return (attrs_.begin ());
+        }
+        inline attr_const_iterator attr_end () const throw ()  {
+
+            return (attrs_.begin () + attr_count_);
+        }
+
+        inline bool has_warning () const throw ()  {
+
+            return (! warning_msgs_.empty ());
+        }
+        inline bool has_error () const throw ()  {
+
+            return (! error_msgs_.empty ());
+        }
+        inline bool has_fatal_error () const throw ()  {
+
+            return (has_problem_);
+        }
+        inline const XmlErrorVector &warnings () const throw ()  {
+
+            return (warning_msgs_);
+        }
+        inline const XmlErrorVector &errors () const throw ()  {
+
+            return (error_msgs_);
+        }
+        inline const std::string &fatal_error () const throw ()  {
+
+            return (fatal_error_);
+        }
+
+    protected:
+
+       // SAX DocumentHandler interface
+       //
+        void startElement (const XMLCh *const name,
+                           AttributeList &attributes) throw ();
+        void endElement (const XMLCh *const name) throw ();
+
+       // SAX ErrorHandler interface
+       //
+        void warning (const SAXParseException &exception) throw ();
+        void error (const SAXParseException &exception) throw ();
+        void fatalError (const SAXParseException &exception) throw ();
+
+    private:
+
+       // Xerces is initialized before anything else in here is constructed,
+       // and terminated after everything else is destroyed.
+       //
+        XMLXercesInitializer                        init_;
+        std::unique_ptr<XMLArenaMemoryManager>      mem_manager_;
+        std::unique_ptr<SAXParser>                  parser_;
+        XERCES_CPP_NAMESPACE::XMLPScanToken         token_;
+        XMLMemBufInputSource                        mem_buf_;
+        std::unique_ptr<XMLCallbackInputSource>     callback_source_;
+
+        bool        open_;
+        bool        has_problem_;
+        bool        got_event_;    // The last scan produced an event
+        bool        have_event_;   // event_ is not handed out by next() yet
+        bool        pending_end_;  // End of the empty element just started
+        bool        skipping_;
+        Event       event_;
+        size_type   depth_;
+        size_type   open_depth_;
+
+        XmlErrorVector  warning_msgs_;
+        XmlErrorVector  error_msgs_;
+        std::string     fatal_error_;
+        std::string     name_;
+        AttrVector      attrs_;
+        size_type       attr_count_;
+
+        void start_ ();
+        bool first_ (const XERCES_CPP_NAMESPACE::InputSource *source,
+                     const char *const file);
+        bool scan_ ();
+        void set_name_ (const XMLCh *const name);
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLCursor (const XMLCursor &);
+        XMLCursor &operator = (const XMLCursor &);
+};
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLCursor_h
+#define _INCLUDED_XMLCursor_h 1
+#endif    // _INCLUDED_XMLCursor_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,410 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLEscape_h
+#define _INCLUDED_XMLEscape_h 0
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif // __SSE2__
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// Escaping of attribute values, so they can be written between double
+// quotes and read back exactly as they were.
+//
+// '"', '<', '&' and '>' become entity references. TAB, LF and CR become
+// character references, since a parser would otherwise normalize them to
+// spaces. Everything else, including UTF-8 multi-byte sequences, is
+// copied as is.
+//
+// Literals, as XMLWriter writes them, are escaped further. The apostrophe
+// becomes "&apos;", and the other control chars and DEL become character
+// references. Valid UTF-8 sequences are copied as is. A byte that is not
+// part of one is taken as Latin-1 and becomes a character reference.
+//
+// Almost all values need no escaping at all. So the scan for the chars to
+// escape goes 16 bytes at a time with SSE2 (where it is available), and
+// the runs in between are handed on in bulk, not char by char.
+//
+
+// ----------------------------------------------------------------------------
+
+// Implementation details
+//
+namespace xml_esc_
+{
+
+// The entity or character reference of each char to escape
+//
+class   Reference  {
+
+    public:
+
+        const   char    *text;
+        std::size_t     len;
+};
+
+inline constexpr Reference  references [] = {
+    { "", 0 },
+    { "&quot;", 6 },
+    { "&amp;", 5 },
+    { "&lt;", 4 },
+    { "&gt;", 4 },
+    { "&#9;", 4 },
+    { "&#10;", 5 },
+    { "&#13;", 5 },
+    { "&apos;", 6 }
+};
+
+// "&#N;" for every byte N
+//
+class   NumericReferences  {
+
+    public:
+
+        char            text [256][7];
+        unsigned char   len [256];
+
+        constexpr NumericReferences () throw () : text (), len ()  {
+
+            for (int c = 0; c < 256; ++c)  {
+                char    *t = text [c];
+                int     n = 0;
+
+                t [n++] = '&';
+                t [n++] = '#';
+                if (c >= 100)
+                    t [n++] = char ('0' + c / 100);
+                if (c >= 10)
+                    t [n++] = char ('0' + c / 10 % 10);
+                t [n++] = char ('0' + c % 10);
+                t [n++] = ';';
+                len [c] = static_cast<unsigned char>(n);
+            }
+        }
+};
+
+inline constexpr NumericReferences  numeric_references {};
+
+// For every byte, its index in references, or 0, if it is left as is
+//
+class   Table  {
+
+    public:
+
+        unsigned char   code [256];
+
+        constexpr Table () throw () : code ()  {
+
+            code [static_cast<unsigned char>('"')] = 1;
+            code [static_cast<unsigned char>('&')] = 2;
+            code [static_cast<unsigned char>('<')] = 3;
+            code [static_cast<unsigned char>('>')] = 4;
+            code [static_cast<unsigned char>('\t')] = 5;
+            code [static_cast<unsigned char>('\n')] = 6;
+            code [static_cast<unsigned char>('\r')] = 7;
+        }
+
+        inline unsigned char operator [] (char c) const throw ()  {
+
+            return (code [static_cast<unsigned char>(c)]);
+        }
+};
+
+inline constexpr Table  attr_table {};
+
+// For literals, the code is an index in references, numeric for a char
+// reference, or utf8 for a byte that may start a UTF-8 sequence.
+//
+class   LiteralTable  {
+
+    public:
+
+        enum  { numeric = 0xFE, utf8 = 0xFF };
+
+        unsigned char   code [256];
+
+        constexpr LiteralTable () throw () : code ()  {
+
+            for (int c = 0; c < 0x20; ++c)
+                code [c] = numeric;
+            code [0x7F] = numeric;
+            for (int c = 0x80; c < 0x100; ++c)
+                code [c] = utf8;
+            code [static_cast<unsigned char>('"')] = 1;
+            code [static_cast<unsigned char>('&')] = 2;
+            code [static_cast<unsigned char>('<')] = 3;
+            code [static_cast<unsigned char>('>')] = 4;
+            code [static_cast<unsigned char>('\'')] = 8;
+        }
+
+        inline unsigned char operator [] (char c) const throw ()  {
+
+            return (code [static_cast<unsigned char>(c)]);
+        }
+};
+
+inline constexpr LiteralTable   literal_table {};
+
+// The length of the valid UTF-8 sequence at str, or 0, if there is none.
+// Overlong forms and surrogates are not valid.
+//
+inline std::size_t
+utf8_len (const char *str, const char *const end) throw ()  {
+
+    const   unsigned char   *s = reinterpret_cast<const unsigned char *>(str);
+    const   std::size_t     avail = std::size_t (end - str);
+    unsigned char           lo = 0x80;
+    unsigned char           hi = 0xBF;
+    std::size_t             len;
+
+    if (s [0] >= 0xC2 && s [0] <= 0xDF)
+        len = 2;
+    else if (s [0] >= 0xE0 && s [0] <= 0xEF)  {
+        len = 3;
+        if (s [0] == 0xE0)
+            lo = 0xA0;
+        else if (s [0] == 0xED)
+            hi = 0x9F;
+    }
+    else if (s [0] >= 0xF0 && s [0] <= 0xF4)  {
+        len = 4;
+        if (s [0] == 0xF0)
+            lo = 0x90;
+        else if (s [0] == 0xF4)
+            hi = 0x8F;
+    }
+    else
+        return (0);
+
+    if (avail < len || s [1] < lo || s [1] > hi)
+        return (0);
+    for (std::size_t i = 2; i < len; ++i)
+        if (s [i] < 0x80 || s [i] > 0xBF)
+            return (0);
+
+    return (len);
+}
+
+} // namespace xml_esc_
+
+// ----------------------------------------------------------------------------
+
+// The first char in [begin, end) that must be escaped, or end
+//
+inline const char *
+XMLescape_find (const char *begin, const char *const end) throw ()  {
+
+#ifdef __SSE2__
+    const   __m128i quot = _mm_set1_epi8 ('"');
+    const   __m128i amp = _mm_set1_epi8 ('&');
+    const   __m128i lt = _mm_set1_epi8 ('<');
+    const   __m128i gt = _mm_set1_epi8 ('>');
+    const   __m128i tab = _mm_set1_epi8 ('\t');
+    const   __m128i lf = _mm_set1_epi8 ('\n');
+    const   __m128i cr = _mm_set1_epi8 ('\r');
+
+    for ( ; end - begin >= 16; begin += 16)  {
+        const   __m128i bytes =
+            _mm_loadu_si128 (reinterpret_cast<const __m128i *>(begin));
+        const   __m128i hits =
+            _mm_or_si128 (
+                _mm_or_si128 (
+                    _mm_or_si128 (_mm_cmpeq_epi8 (bytes, quot),
+                                  _mm_cmpeq_epi8 (bytes, amp)),
+                    _mm_or_si128 (_mm_cmpeq_epi8 (bytes, lt),
+                                  _mm_cmpeq_epi8 (bytes, gt))),
+                _mm_or_si128 (
+                    _mm_or_si128 (_mm_cmpeq_epi8 (bytes, tab),
+                                  _mm_cmpeq_epi8 (bytes, lf)),
+                    _mm_cmpeq_epi8 (bytes, cr)));
+        const   int     mask = _mm_movemask_epi8 (hits);
+
+        if (mask != 0)
+            return (begin + __builtin_ctz (mask));
+    }
+#endif // __SSE2__
+
+    while (begin < end && ! xml_esc_::attr_table [*begin])
+        ++begin;
+    return (begin);
+}
+
+// ----------------------------------------------------------------------------
+
+// The first char in [begin, end) that is not a printable ASCII char, other
+// than '"', '&', '<', '>' and '\'', or end
+//
+inline const char *
+XMLliteral_find (const char *begin, const char *const end) throw ()  {
+
+#ifdef __SSE2__
+    const   __m128i quot = _mm_set1_epi8 ('"');
+    const   __m128i amp = _mm_set1_epi8 ('&');
+    const   __m128i lt = _mm_set1_epi8 ('<');
+    const   __m128i gt = _mm_set1_epi8 ('>');
+    const   __m128i apos = _mm_set1_epi8 ('\'');
+    const   __m128i space = _mm_set1_epi8 (' ');
+    const   __m128i del = _mm_set1_epi8 (0x7F);
+
+    for ( ; end - begin >= 16; begin += 16)  {
+        const   __m128i bytes =
+            _mm_loadu_si128 (reinterpret_cast<const __m128i *>(begin));
+
+       // As signed chars, the bytes from 0x80 up are less than ' ' too
+       //
+        const   __m128i hits =
+            _mm_or_si128 (
+                _mm_or_si128 (
+                    _mm_or_si128 (_mm_cmpeq_epi8 (bytes, quot),
+                                  _mm_cmpeq_epi8 (bytes, amp)),
+                    _mm_or_si128 (_mm_cmpeq_epi8 (bytes, lt),
+                                  _mm_cmpeq_epi8 (bytes, gt))),
+                _mm_or_si128 (
+                    _mm_or_si128 (_mm_cmpeq_epi8 (bytes, apos),
+                                  _mm_cmplt_epi8 (bytes, space)),
+                    _mm_cmpeq_epi8 (bytes, del)));
+        const   int     mask = _mm_movemask_epi8 (hits);
+
+        if (mask != 0)
+            return (begin + __builtin_ctz (mask));
+    }
+#endif // __SSE2__
+
+    while (begin < end && ! xml_esc_::literal_table [*begin])
+        ++begin;
+    return (begin);
+}
+
+// ----------------------------------------------------------------------------
+
+// The length of the len chars at str, once escaped
+//
+inline std::size_t XMLescaped_len (const char *str, std::size_t len) throw ()  {
+
+    const   char    *const  end = str + len;
+
+    while ((str = XMLescape_find (str, end)) != end)  {
+        len += xml_esc_::references [xml_esc_::attr_table [*str]].len - 1;
+        str += 1;
+    }
+
+    return (len);
+}
+
+// ----------------------------------------------------------------------------
+
+// Escapes the len chars at str. put (const char *, std::size_t) is called,
+// in order, with the runs of chars that are left as is and with the
+// references that replace the others.
+//
+template<typename xml_PUT>
+inline void XMLescape (const char *str, std::size_t len, xml_PUT &&put)  {
+
+    const   char    *const  end = str + len;
+
+    while (str < end)  {
+        const   char    *const  hit = XMLescape_find (str, end);
+
+        if (hit != str)
+            put (str, std::size_t (hit - str));
+        if (hit == end)
+            break;
+
+        const   xml_esc_::Reference &ref =
+            xml_esc_::references [xml_esc_::attr_table [*hit]];
+
+        put (ref.text, ref.len);
+        str = hit + 1;
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Escapes the len chars at str as a literal. put is called as in
+// XMLescape(). Valid UTF-8 sequences don't break the runs.
+//
+template<typename xml_PUT>
+inline void
+XMLencode_literal (const char *str, std::size_t len, xml_PUT &&put)  {
+
+    const   char    *const  end = str + len;
+    const   char            *run = str;
+
+    while ((str = XMLliteral_find (str, end)) != end)  {
+        const   unsigned char   code = xml_esc_::literal_table [*str];
+
+        if (code == xml_esc_::LiteralTable::utf8)  {
+            const   std::size_t seq_len = xml_esc_::utf8_len (str, end);
+
+            if (seq_len > 0)  {
+                str += seq_len;
+                continue;
+            }
+        }
+
+        if (run != str)
+            put (run, std::size_t (str - run));
+        if (code < xml_esc_::LiteralTable::numeric)
+            put (xml_esc_::references [code].text,
+                 xml_esc_::references [code].len);
+        else  {
+            const   unsigned char   c = static_cast<unsigned char>(*str);
+
+            put (xml_esc_::numeric_references.text [c],
+                 xml_esc_::numeric_references.len [c]);
+        }
+        run = ++str;
+    }
+    if (run != end)
+        put (run, std::size_t (end - run));
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Appends the escaped str to out. It grows out only once.
+//
+inline std::string &
+XMLescape_append (std::string &out, const char *str, std::size_t len)  {
+
+    const   std::string::size_type  start = out.size ();
+
+    out.resize (start + XMLescaped_len (str, len));
+
+    char    *dst = &(out [0]) + start;
+
+    XMLescape (str, len, [&dst] (const char *run, std::size_t n)  {
+        ::memcpy (dst, run, n);
+        dst += n;
+    });
+
+    return (out);
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLEscape_h
+#define _INCLUDED_XMLEscape_h 1
+#endif    // _INCLUDED_XMLEscape_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
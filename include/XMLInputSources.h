@@ -0,0 +1,231 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLInputSources_h
+#define _INCLUDED_XMLInputSources_h 0
+
+// ----------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/util/BinInputStream.hpp>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// This is how bytes are pulled into the parser from anywhere: std::istream,
+// a file descriptor, a pipe from a decompressor, a socket, ...
+// The callback fills up to max_size bytes of buffer and returns the number
+// of bytes it filled, 0 at the end of input, or a negative number on error.
+// Xerces calls it with its own (fixed size) raw buffer, so the memory used
+// for input stays constant, regardless of the size of the document.
+//
+typedef std::function<long (char *buffer, std::size_t max_size)>
+    XMLReadCallback;
+
+// Interrupts blocking fd reads from another thread. An fd reader that is
+// made with a canceller waits for its fd and for the canceller at the same
+// time (see poll()). Once cancel() is called, it returns -1 with errno set
+// to ECANCELED, instead of blocking.
+//
+class   XMLReadCanceller  {
+
+    public:
+
+        XMLReadCanceller ();
+        ~XMLReadCanceller () throw ();
+
+        void cancel () throw ();
+        inline bool is_cancelled () const throw ()  { return (cancelled_); }
+
+       // Readable once cancel() is called
+       //
+        inline int get_fd () const throw ()  { return (pipe_ [0]); }
+
+    private:
+
+        int                 pipe_ [2];
+        std::atomic<bool>   cancelled_;
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLReadCanceller (const XMLReadCanceller &);
+        XMLReadCanceller &operator = (const XMLReadCanceller &);
+};
+
+// Adapters for the common cases. The stream or fd must outlive the parse.
+// If will_need is not 0, the fd reader advises the kernel that the fd is
+// read sequentially, and after each read, that the next will_need bytes
+// will be needed (see posix_fadvise()).
+// The fd reader waits with poll(), if the fd is non-blocking. If canceller
+// is not NULL and fd is not a regular file, it always waits with poll(),
+// so the read can be cancelled.
+//
+XMLReadCallback XMLmake_stream_reader (std::istream &is);
+XMLReadCallback
+XMLmake_fd_reader (int fd,
+                   std::size_t will_need = 0,
+                   const std::shared_ptr<XMLReadCanceller> &canceller =
+                       std::shared_ptr<XMLReadCanceller> ());
+
+// Compressed input:
+//
+// XMLsniff_compression() looks at the first few bytes of an input and tells
+// whether it is gzip or zstd compressed, by their magic numbers.
+//
+// XMLmake_decompress_reader() wraps a read callback. It sniffs the first
+// bytes and, if they are compressed, decompresses the input as it is read.
+// Otherwise, it passes the input through as is. Concatenated gzip members
+// and zstd frames are read as one stream.
+//
+// NOTE: gzip support is compiled in only if the library is built with
+//       XMLPARSER_HAVE_ZLIB defined (and linked with -lz), and zstd support
+//       only with XMLPARSER_HAVE_ZSTD defined (and linked with -lzstd).
+//       Reading a compressed input without the support compiled in throws
+//       std::runtime_error.
+//
+enum XMLCompression  {
+    xml_no_compression = 0,
+    xml_gzip = 1,
+    xml_zstd = 2
+};
+
+XMLCompression
+XMLsniff_compression (const char *buffer, std::size_t size) throw ();
+XMLReadCallback XMLmake_decompress_reader (const XMLReadCallback &raw_cb);
+
+// XMLmake_prefetch_reader() runs src_cb on its own thread, reading ahead
+// into two buffers of buffer_size bytes each, while the parser consumes
+// the other one. Wrapped around a decompress reader, decompression and
+// parsing overlap. A buffer is handed over after every read, so bytes that
+// trickle in through a pipe or a socket are parsed as they come. Errors
+// and exceptions of src_cb are handed over to the reading side.
+// The thread is joined when the last copy of the returned callback is
+// destroyed, e.g. when a parse stops early. If canceller is not NULL, it
+// is cancelled first, so a thread that is blocked in an fd reader made
+// with the same canceller returns at once. Otherwise, the join waits for
+// the src_cb call in progress to return.
+// If stall_ns is not NULL, the nanoseconds the reading side spends waiting
+// for the thread are added to it.
+//
+XMLReadCallback
+XMLmake_prefetch_reader (const XMLReadCallback &src_cb,
+                         std::size_t buffer_size = 256 * 1024,
+                         unsigned long long *stall_ns = NULL,
+                         const std::shared_ptr<XMLReadCanceller> &canceller =
+                             std::shared_ptr<XMLReadCanceller> ());
+
+// ----------------------------------------------------------------------------
+
+// A Xerces input stream that pulls its bytes through a read callback
+//
+class   XMLCallbackInputStream : public XERCES_CPP_NAMESPACE::BinInputStream  {
+
+    public:
+
+        XMLCallbackInputStream (const XMLReadCallback &read_cb,
+                                XMLFilePos *bytes_read = NULL) throw ();
+
+        XMLFilePos curPos () const;
+        XMLSize_t readBytes (XMLByte *const to_fill, const XMLSize_t max_read);
+        const XMLCh *getContentType () const;
+
+    private:
+
+        XMLReadCallback read_cb_;
+        XMLFilePos      pos_;
+        XMLFilePos      *bytes_read_;
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLCallbackInputStream (const XMLCallbackInputStream &);
+        XMLCallbackInputStream &operator = (const XMLCallbackInputStream &);
+};
+
+// ----------------------------------------------------------------------------
+
+// A Xerces input source over a read callback. After a parse, bytes_read()
+// tells how many bytes were pulled through the callback.
+//
+// NOTE: It can be parsed only once, since the callback can't be rewound.
+//
+class   XMLCallbackInputSource : public XERCES_CPP_NAMESPACE::InputSource  {
+
+    public:
+
+        XMLCallbackInputSource (
+            const XMLReadCallback &read_cb,
+            const char *const sys_id,
+            XERCES_CPP_NAMESPACE::MemoryManager *const mem_manager);
+
+        XERCES_CPP_NAMESPACE::BinInputStream *makeStream () const;
+
+        inline XMLFilePos bytes_read () const throw ()  {
+
+            return (bytes_read_);
+        }
+
+    private:
+
+        XMLReadCallback     read_cb_;
+        mutable XMLFilePos  bytes_read_;
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLCallbackInputSource (const XMLCallbackInputSource &);
+        XMLCallbackInputSource &operator = (const XMLCallbackInputSource &);
+};
+
+// ----------------------------------------------------------------------------
+
+// A Xerces input source over a string in memory, that is bound once and
+// pointed at a new string for each parse. It doesn't copy or adopt the
+// string. The system id is only transcoded, if it has changed since the
+// last string.
+//
+class   XMLMemBufInputSource
+    : public XERCES_CPP_NAMESPACE::MemBufInputSource  {
+
+    public:
+
+        explicit XMLMemBufInputSource (
+            XERCES_CPP_NAMESPACE::MemoryManager *const mem_manager);
+
+        void reset (const char *const xml,
+                    std::size_t xml_len,
+                    const char *const sys_id);
+
+    private:
+
+        std::string sys_id_;
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLMemBufInputSource (const XMLMemBufInputSource &);
+        XMLMemBufInputSource &operator = (const XMLMemBufInputSource &);
+};
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLInputSources_h
+#define _INCLUDED_XMLInputSources_h 1
+#endif    // _INCLUDED_XMLInputSources_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
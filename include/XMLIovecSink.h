@@ -0,0 +1,174 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLIovecSink_h
+#define _INCLUDED_XMLIovecSink_h 0
+
+// ----------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include <XMLEscape.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// This gathers output as a batch of iovecs and writes it to a file
+// descriptor with writev(), without first copying it all into one buffer.
+//
+// put() refers to the given chars in place. They must stay as they are
+// until the next flush(). Pieces shorter than copy_limit are copied into a
+// scratch buffer instead, so the many small pieces of XML (quotes, angle
+// brackets, short names) don't each take an iovec. copy() always copies.
+// Pieces that are next to each other in memory share one iovec.
+// The batch is written out when it has IOV_MAX iovecs or the scratch
+// buffer is full, and by flush().
+//
+// A tree is written with XMLTreeNodes::dump_to_sink(). Names and values
+// are then referred to in the tree, so the tree must not change until the
+// sink is flushed:
+//
+//     XMLIovecSink    sink (socket_fd);
+//
+//     root.dump_to_sink (sink, XMLTreeNodes::df_compact);
+//     sink.flush ();
+//
+// It is also "stream like" enough for XMLStreamWriter<XMLIovecSink>. The
+// strings that XMLWriter writes don't outlive the call, so those are
+// copied.
+//
+// The fd may be non-blocking. flush() then waits with poll() for it to be
+// writable. Errors throw std::runtime_error. What was not written by then
+// is kept, and is tried again by the next flush().
+//
+// NOTE: The destructor doesn't flush, since it cannot report a failure.
+//       Call flush() when done.
+//
+class   XMLIovecSink  {
+
+    public:
+
+        typedef std::size_t size_type;
+
+        explicit XMLIovecSink (int fd,
+                               size_type scratch_size = 64 * 1024,
+                               size_type copy_limit = 64);
+        ~XMLIovecSink () throw ();
+
+        inline void put (const char *str, size_type len)  {
+
+            if (len < copy_limit_)
+                copy (str, len);
+            else
+                refer_ (str, len);
+            return;
+        }
+        inline void put (const char *str)  { put (str, ::strlen (str)); }
+
+        inline void copy (const char *str, size_type len)  {
+
+           // A flush after the copy would let the next copy overwrite it
+           //
+            if (len > scratch_.size () - scratch_used_ ||
+                iovecs_.size () == max_iovecs_)  {
+                flush ();
+                if (len > scratch_.size ())  {  // Write it while it's there
+                    refer_ (str, len);
+                    flush ();
+                    return;
+                }
+            }
+
+            char    *const  dst = &(scratch_ [0]) + scratch_used_;
+
+            ::memcpy (dst, str, len);
+            scratch_used_ += len;
+            refer_ (dst, len);
+            return;
+        }
+
+        inline void put_escaped (const char *str)  {
+
+            XMLescape (str, ::strlen (str),
+                       [this] (const char *run, size_type len)  {
+                           put (run, len);
+                       });
+        }
+        void spaces (size_type count);
+
+        inline XMLIovecSink &operator << (const char *str)  {
+
+            copy (str, ::strlen (str));
+            return (*this);
+        }
+
+       // Writes out everything that is gathered so far
+       //
+        void flush ();
+
+        inline int get_fd () const throw ()  { return (fd_); }
+        inline size_type pending_bytes () const throw ()  { return (pending_); }
+        inline size_type bytes_written () const throw ()  { return (written_); }
+
+    private:
+
+        const   int                 fd_;
+        const   size_type           copy_limit_;
+        const   size_type           max_iovecs_;
+        std::vector<struct iovec>   iovecs_;
+        std::vector<char>           scratch_;
+        size_type                   scratch_used_;
+        size_type                   pending_;
+        size_type                   written_;
+
+        inline void refer_ (const char *str, size_type len)  {
+
+            if (len == 0)
+                return;
+            if (! iovecs_.empty ())  {
+                struct iovec    &last = iovecs_.back ();
+
+                if (static_cast<const char *>(last.iov_base) + last.iov_len ==
+                        str)  {
+                    last.iov_len += len;
+                    pending_ += len;
+                    return;
+                }
+                if (iovecs_.size () == max_iovecs_)
+                    flush ();
+            }
+
+            iovecs_.push_back (iovec ());
+            iovecs_.back ().iov_base = const_cast<char *>(str);
+            iovecs_.back ().iov_len = len;
+            pending_ += len;
+            return;
+        }
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLIovecSink (const XMLIovecSink &);
+        XMLIovecSink &operator = (const XMLIovecSink &);
+};
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLIovecSink_h
+#define _INCLUDED_XMLIovecSink_h 1
+#endif    // _INCLUDED_XMLIovecSink_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -7,9 +7,11 @@
 #define _INCLUDED_XMLNVPair_h 0
 
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
+#include <XMLEscape.h>
 #include <XMLString.h>
 
 // ----------------------------------------------------------------------------
@@ -43,6 +45,44 @@ class   XMLNVPair  {
         typedef unsigned int            size_type;
         typedef const CharType *const   ConstStrType;
 
+    private:
+
+       // The name and the value share one buffer. It is preceded by its
+       // capacity, so a recycled buffer is reused up to its real size and
+       // heap_bytes() reports what is really held.
+       //
+        static inline StrType allocate_ (size_type capacity)  {
+
+            CharType    *const  raw =
+                new CharType [sizeof (size_type) + capacity];
+
+            ::memcpy (raw, &capacity, sizeof (size_type));
+            return (raw + sizeof (size_type));
+        }
+        static inline void deallocate_ (StrType buffer) throw ()  {
+
+            if (buffer != NULL)
+                delete[] (buffer - sizeof (size_type));
+        }
+        inline size_type capacity_ () const throw ()  {
+
+            size_type   capacity;
+
+            ::memcpy (&capacity, buffer_ - sizeof (size_type),
+                      sizeof (size_type));
+            return (capacity);
+        }
+        inline void reserve_ (size_type size)  {
+
+            if (buffer_ == NULL || capacity_ () < size)  {
+                deallocate_ (buffer_);
+                buffer_ = NULL;
+                buffer_ = allocate_ (size);
+            }
+        }
+
+    public:
+
         inline XMLNVPair () throw () : buffer_ (NULL)  {   }
         inline XMLNVPair (ConstStrType name,
                               ConstStrType value) throw () : buffer_ (NULL)  {
@@ -54,7 +94,7 @@ class   XMLNVPair  {
 
             *this = that;
         }
-        inline ~XMLNVPair () throw ()  { delete[] buffer_; }
+        inline ~XMLNVPair () throw ()  { deallocate_ (buffer_); }
 
         inline XMLNVPair &operator = (const XMLNVPair &rhs) throw ()  {
 
@@ -71,17 +111,12 @@ class   XMLNVPair  {
                 const   size_type   nlen = ::strlen (name);
                 const   size_type   vlen = ::strlen (value);
 
-                if (buffer_ == NULL || ::strlen (get_name ()) +
-                                       ::strlen (get_value()) < nlen + vlen)  {
-                    delete[] buffer_;
-                    buffer_ = new CharType [nlen + vlen + 2];
-                }
-
+                reserve_ (nlen + vlen + 2);
                 ::strcpy (buffer_, name);
                 ::strcpy (buffer_ + nlen + 1, value);
             }
             else  {
-                delete[] buffer_;
+                deallocate_ (buffer_);
                 buffer_ = NULL;
             }
 
@@ -94,21 +129,35 @@ class   XMLNVPair  {
             typedef XERCES_CPP_NAMESPACE::XMLString XERCString;
 
             if (name && value)  {
-                const   size_type   nlen = XMLString::charstar_len (name);
-                const   size_type   vlen = XMLString::charstar_len (value);
-
-                if (buffer_ == NULL ||
-                    ::strlen (get_name ()) + ::strlen (get_value ()) <
-                        nlen + vlen)  {
-                    delete[] buffer_;
-                    buffer_ = new CharType [nlen + vlen + 2];
+                XMLString::size_type    nlen = 0;
+                XMLString::size_type    vlen = 0;
+
+               // Almost all names and values are plain ASCII, and those are
+               // sized and narrowed in one pass each, without the Xerces
+               // transcoder. This matters most for values that are dense
+               // with (already decoded) entity and character references.
+               //
+                const   bool    is_ascii =
+                    XMLString::ascii_len (name, nlen) &&
+                    XMLString::ascii_len (value, vlen);
+
+                if (! is_ascii)  {
+                    nlen = XMLString::charstar_len (name);
+                    vlen = XMLString::charstar_len (value);
                 }
 
-                XERCString::transcode (name, buffer_, nlen);
-                XERCString::transcode (value, buffer_ + nlen + 1, vlen);
+                reserve_ (nlen + vlen + 2);
+                if (is_ascii)  {
+                    XMLString::narrow_ascii (name, buffer_, nlen);
+                    XMLString::narrow_ascii (value, buffer_ + nlen + 1, vlen);
+                }
+                else  {
+                    XERCString::transcode (name, buffer_, nlen);
+                    XERCString::transcode (value, buffer_ + nlen + 1, vlen);
+                }
             }
             else  {
-                delete[] buffer_;
+                deallocate_ (buffer_);
                 buffer_ = NULL;
             }
 
@@ -121,24 +170,44 @@ class   XMLNVPair  {
             return (buffer_ ? buffer_ + ::strlen (buffer_) + 1 : buffer_);
         }
 
+       // The value is escaped, so it reads back as it is. See XMLEscape.h
+       //
         inline std::ostream &
         dump (std::ostream &os, const char *const prefix = "") const  {
 
-            os << prefix << get_name () << " = \"" << get_value () << "\"\n";
+            const   char    *const  value = get_value ();
+
+            os << prefix << get_name () << " = \"";
+            XMLescape (value, ::strlen (value),
+                       [&os] (const char *run, std::size_t len)  {
+                           os.write (run, len);
+                       });
+            os << "\"\n";
 
             return (os);
         }
 
         inline std::string &dump (std::string &str) const  {
 
+            const   char    *const  value = get_value ();
+
             str += get_name ();
             str += "=\"";
-            str += get_value ();
+            XMLescape_append (str, value, ::strlen (value));
             str += "\" ";
 
             return (str);
         }
 
+       // Bytes held on the heap for the name and value. This is the whole
+       // buffer, which is larger than the pair, if it was recycled from a
+       // longer pair.
+       //
+        inline size_type heap_bytes () const throw ()  {
+
+            return (buffer_ ? sizeof (size_type) + capacity_ () : 0);
+        }
+
         inline bool operator == (const XMLNVPair &rhs) const throw ()  {
 
             return (! ::strcmp (get_name (), rhs.get_name ()));
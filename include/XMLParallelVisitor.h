@@ -0,0 +1,343 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLParallelVisitor_h
+#define _INCLUDED_XMLParallelVisitor_h 0
+
+// ----------------------------------------------------------------------------
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <XMLTreeNodes.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// This runs a functor over every node of a tree (a node and all its
+// descendants) on a number of threads:
+//
+//     XMLParallelVisitor  visitor;
+//     const   std::size_t fields = visitor.reduce (
+//         root,
+//         std::size_t (0),
+//         [] (std::size_t &count, const XMLTreeNodes &node)  {
+//             count += ! ::strcmp (node.get_name (), "FIELD");
+//         },
+//         [] (std::size_t a, std::size_t b)  { return (a + b); });
+//
+// The threads are started once, by the constructor, and wait for work
+// between visits. The calling thread is one of them.
+// The tree is not looked at before the visit. A visit starts as one task,
+// the whole tree, and work is split only when a thread is idle. Every
+// thread has its own deque of tasks. It takes its own tasks from the back,
+// and when it runs out, it steals from the front of the others' deques.
+// A thread that is walking a task and sees an idle thread, while its own
+// deque is empty, gives away siblings it has not walked yet: those of the
+// shallowest node on its path that has any, so the piece given away is
+// as big as it can be. It looks at most grain siblings ahead, keeps half
+// of those and gives away the rest. Splitting costs nothing when no
+// thread is idle, and nothing in the walk depends on the tree's depth.
+//
+// reduce() gives every thread its own copy of identity to accumulate into,
+// and combines them at the end. combine must be associative and
+// commutative, since which thread visits which node is not determined.
+// for_each() only calls the functor.
+// If a functor throws, the other threads stop as soon as they finish their
+// current task, and the exception is thrown out of reduce() or for_each().
+// An idle thread tries for a short while and then sleeps until a task is
+// given away or the visit is done.
+//
+// NOTE: The functors are called concurrently. The tree must not be changed
+//       while it is visited. One visitor object runs one visit at a time.
+//
+class   XMLParallelVisitor  {
+
+    public:
+
+        typedef std::size_t size_type;
+
+       // threads of 0 means as many as there are cores. If a thread cannot
+       // be started, the ones that were are stopped and the exception is
+       // thrown.
+       //
+        explicit XMLParallelVisitor (size_type threads = 0,
+                                     size_type grain = 4096);
+        ~XMLParallelVisitor ();
+
+        inline size_type threads () const throw ()  {
+
+            return (workers_.size ());
+        }
+        inline size_type grain () const throw ()  { return (grain_); }
+
+       // func is called as func (acc, node), where acc is a T &
+       //
+        template<typename T, typename xml_FUNC, typename xml_COMBINE>
+        T reduce (const XMLTreeNodes &root,
+                  const T &identity,
+                  xml_FUNC func,
+                  xml_COMBINE combine);
+
+       // func is called as func (node)
+       //
+        template<typename xml_FUNC>
+        void for_each (const XMLTreeNodes &root, xml_FUNC func);
+
+    private:
+
+       // A run of sibling subtrees, from first up to (not including) end
+       //
+        class   Task_  {
+
+            public:
+
+                const   XMLTreeNodes    *first;
+                const   XMLTreeNodes    *end;
+        };
+
+       // A node on the path of a walk that has siblings left to walk,
+       // up to (not including) end
+       //
+        class   Level_  {
+
+            public:
+
+                const   XMLTreeNodes    *node;
+                const   XMLTreeNodes    *end;
+        };
+
+        class   alignas (64) Worker_  {
+
+            public:
+
+                inline Worker_ () throw () : queued (0), live (0)  {   }
+
+                std::mutex              mutex;
+                std::deque<Task_>       tasks;
+                std::atomic<size_type>  queued;  // tasks.size ()
+
+               // The levels of the task being walked. The ones before
+               // live have been given away.
+               //
+                std::vector<Level_>     path;
+                size_type               live;
+                std::exception_ptr      error;
+        };
+
+       // A per thread accumulator, on its own cache line
+       //
+        template<typename T>
+        class   alignas (64) Accumulator_  {
+
+            public:
+
+                explicit Accumulator_ (const T &identity) : value (identity)  {
+                }
+
+                T   value;
+        };
+
+        typedef std::function<void (size_type worker, const Task_ &task)>
+            TaskFunc_;
+
+        const   size_type                       grain_;
+        std::vector<std::unique_ptr<Worker_> >  workers_;
+        std::vector<std::thread>                threads_;
+
+       // Tasks that are queued or running, threads looking for one and
+       // the ones of those that sleep on task_cond_
+       //
+        std::atomic<size_type>                  pending_;
+        std::atomic<size_type>                  idle_;
+        std::atomic<size_type>                  sleeping_;
+        std::atomic<bool>                       abort_;
+
+       // These hand a visit to the threads and wait for them to finish it
+       //
+        std::mutex                              mutex_;
+        std::condition_variable                 start_cond_;
+        std::condition_variable                 done_cond_;
+        std::condition_variable                 task_cond_;
+        const   TaskFunc_                       *task_func_;
+        size_type                               visit_;
+        size_type                               running_;
+        bool                                    stop_;
+
+        void stop_threads_ () throw ();
+        void thread_loop_ (size_type worker);
+
+       // Runs the visit on all the threads until no task is left
+       //
+        void run_ (const XMLTreeNodes &root, const TaskFunc_ &task_func);
+        void work_ (size_type worker);
+        bool take_ (size_type worker, Task_ &task);
+        void push_ (Worker_ &worker, const Task_ &task);
+        void wait_for_task_ ();
+        void wake_idle_ (bool all);
+
+       // Gives away the unwalked siblings of the shallowest level of the
+       // worker's path
+       //
+        void split_ (Worker_ &worker);
+
+        inline bool split_wanted_ (const Worker_ &worker) const throw ()  {
+
+            return (worker.live < worker.path.size () &&
+                    idle_.load (std::memory_order_relaxed) != 0 &&
+                    worker.queued.load (std::memory_order_relaxed) == 0);
+        }
+
+       // Moves node to the next node of the task in pre-order. It returns
+       // false when the task is done.
+       //
+        static bool
+        advance_ (Worker_ &worker, const XMLTreeNodes *&node, size_type &depth)
+            throw ();
+
+        template<typename T, typename xml_FUNC>
+        void run_task_ (Worker_ &worker,
+                        const Task_ &task,
+                        T &acc,
+                        xml_FUNC &func);
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLParallelVisitor (const XMLParallelVisitor &);
+        XMLParallelVisitor &operator = (const XMLParallelVisitor &);
+};
+
+// ----------------------------------------------------------------------------
+
+inline bool XMLParallelVisitor::
+advance_ (Worker_ &worker, const XMLTreeNodes *&node, size_type &depth)
+    throw ()  {
+
+    std::vector<Level_> &path = worker.path;
+
+    if (node->get_child () != NULL)  {
+        node = node->get_child ();
+        depth += 1;
+        if (node->get_sibling () != NULL)
+            path.push_back (Level_ { node, NULL });
+        return (true);
+    }
+
+    for (;;)  {
+        if (! path.empty () && path.back ().node == node)  {
+            Level_  &level = path.back ();
+
+            if (path.size () > worker.live)  {
+                node = node->get_sibling ();
+                if (node->get_sibling () == level.end)
+                    path.pop_back ();
+                else
+                    level.node = node;
+                return (true);
+            }
+            path.pop_back ();  // Its siblings were given away
+            worker.live = path.size ();
+        }
+        if (depth == 0)
+            return (false);
+        node = node->get_parent ();
+        depth -= 1;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+template<typename T, typename xml_FUNC>
+void XMLParallelVisitor::run_task_ (Worker_ &worker,
+                                    const Task_ &task,
+                                    T &acc,
+                                    xml_FUNC &func)  {
+
+    const   XMLTreeNodes    *node = task.first;
+    size_type               depth = 0;
+
+    worker.path.clear ();
+    worker.live = 0;
+    if (node->get_sibling () != task.end)
+        worker.path.push_back (Level_ { node, task.end });
+
+    do  {
+        func (acc, *node);
+        if (split_wanted_ (worker))
+            split_ (worker);
+    } while (advance_ (worker, node, depth));
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+template<typename T, typename xml_FUNC, typename xml_COMBINE>
+T XMLParallelVisitor::reduce (const XMLTreeNodes &root,
+                              const T &identity,
+                              xml_FUNC func,
+                              xml_COMBINE combine)  {
+
+    std::vector<std::unique_ptr<Accumulator_<T> > >   accs;
+
+    accs.reserve (workers_.size ());
+    for (size_type i = 0; i < workers_.size (); ++i)
+        accs.push_back (std::unique_ptr<Accumulator_<T> >
+                            (new Accumulator_<T> (identity)));
+
+    run_ (root,
+          [this, &accs, &func] (size_type worker, const Task_ &task)  {
+              run_task_ (*(workers_ [worker]), task, accs [worker]->value,
+                         func);
+          });
+
+    T   result = accs [0]->value;
+
+    for (size_type i = 1; i < accs.size (); ++i)
+        result = combine (result, accs [i]->value);
+    return (result);
+}
+
+// ----------------------------------------------------------------------------
+
+template<typename xml_FUNC>
+void XMLParallelVisitor::for_each (const XMLTreeNodes &root, xml_FUNC func)  {
+
+    run_ (root,
+          [this, &func] (size_type worker, const Task_ &task)  {
+              char    nothing = 0;
+              auto    visit = [&func] (char &, const XMLTreeNodes &node)  {
+                  func (node);
+              };
+
+              run_task_ (*(workers_ [worker]), task, nothing, visit);
+          });
+
+    return;
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLParallelVisitor_h
+#define _INCLUDED_XMLParallelVisitor_h 1
+#endif    // _INCLUDED_XMLParallelVisitor_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,126 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLParseStats_h
+#define _INCLUDED_XMLParseStats_h 0
+
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// These are the statistics that an XMLParser collects, if one is attached to
+// it by XMLParser::set_stats(). The counters accumulate over all documents
+// parsed, until clear() is called.
+//
+// NOTE: Collecting statistics is compiled in only, if the library is built
+//       with XMLPARSER_STATS defined. Otherwise, the parser never touches
+//       the attached object and there is no cost at all.
+//
+// The time spent in Xerces is what is left of the total parse time after
+// taking out the time spent in our handlers building the tree, and in
+// transcoding names and values.
+// The time spent waiting for input from a reader thread is counted in
+// input_stall_ns and not in xerces_ns.
+// Transcoding time covers only the transcoding of names and values. To time
+// it on its own, names and values are transcoded into scratch buffers first
+// and copied into the tree after that.
+// Bytes consumed are the bytes fed to the scanner, after decompression.
+// They are not known for what parse_file() hands to Xerces by name, e.g. a
+// URL.
+// Bytes allocated for the tree count new nodes, their names, new attribute
+// buffers and the growth of the attribute vector. They don't count
+// recycled buffers that had to grow.
+//
+class   XMLParseStats  {
+
+    public:
+
+        typedef unsigned long long  counter_type;
+
+        inline XMLParseStats () throw ()  { clear (); }
+
+        counter_type    documents;
+        counter_type    elements;
+        counter_type    attributes;
+        counter_type    bytes_consumed;
+        counter_type    max_depth;
+
+        counter_type    total_ns;
+        counter_type    xerces_ns;
+        counter_type    tree_building_ns;
+        counter_type    transcoding_ns;
+        counter_type    input_stall_ns;
+
+        counter_type    tree_bytes_allocated;
+        counter_type    xerces_bytes_allocated;
+
+        inline void clear () throw ()  {
+
+            documents = 0;
+            elements = 0;
+            attributes = 0;
+            bytes_consumed = 0;
+            max_depth = 0;
+            total_ns = 0;
+            xerces_ns = 0;
+            tree_building_ns = 0;
+            transcoding_ns = 0;
+            input_stall_ns = 0;
+            tree_bytes_allocated = 0;
+            xerces_bytes_allocated = 0;
+        }
+
+        static inline counter_type now_ns () throw ()  {
+
+            return (std::chrono::duration_cast<std::chrono::nanoseconds>
+                        (std::chrono::steady_clock::now ().
+                             time_since_epoch ()).count ());
+        }
+
+        inline std::ostream &dump (std::ostream &os) const  {
+
+            os << "documents: " << documents << "\n"
+               << "elements: " << elements << "\n"
+               << "attributes: " << attributes << "\n"
+               << "bytes_consumed: " << bytes_consumed << "\n"
+               << "max_depth: " << max_depth << "\n"
+               << "total_ns: " << total_ns << "\n"
+               << "xerces_ns: " << xerces_ns << "\n"
+               << "tree_building_ns: " << tree_building_ns << "\n"
+               << "transcoding_ns: " << transcoding_ns << "\n"
+               << "input_stall_ns: " << input_stall_ns << "\n"
+               << "tree_bytes_allocated: " << tree_bytes_allocated << "\n"
+               << "xerces_bytes_allocated: " << xerces_bytes_allocated
+               << "\n";
+
+            return (os);
+        }
+};
+
+// ----------------------------------------------------------------------------
+
+inline std::ostream &operator << (std::ostream &os, const XMLParseStats &ps)  {
+
+    return (ps.dump (os));
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLParseStats_h
+#define _INCLUDED_XMLParseStats_h 1
+#endif  // _INCLUDED_XMLParseStats_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -13,13 +13,22 @@
 #include <string>
 #include <vector>
 #include <stack>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #include <DMScu_PtrVector.h>
 
+#include <XMLArenaMemoryManager.h>
+#include <XMLInputSources.h>
+#include <XMLParseStats.h>
 #include <XMLTreeNodes.h>
 
 #include <xercesc/sax/HandlerBase.hpp>
 #include <xercesc/parsers/SAXParser.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/framework/XMLGrammarPool.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
 
 // ----------------------------------------------------------------------------
@@ -34,10 +43,19 @@ class   XMLParser : public XERCES_CPP_NAMESPACE::HandlerBase  {
         typedef XERCES_CPP_NAMESPACE::SAXParser         SAXParser;
         typedef XERCES_CPP_NAMESPACE::SAXParseException SAXParseException;
         typedef XERCES_CPP_NAMESPACE::AttributeList     AttributeList;
+        typedef XERCES_CPP_NAMESPACE::InputSource       InputSource;
 
     public:
 
-        typedef unsigned int    size_type;
+        typedef unsigned int                                size_type;
+        typedef XERCES_CPP_NAMESPACE::Grammar::GrammarType  GrammarType;
+
+       // See set_file_input()
+       //
+        enum FileInput  {
+            fi_xerces = 0,
+            fi_read_ahead = 1
+        };
 
         XMLParser (XMLTreeNodes &i_n,
                        XMLTreeNodes::attr_vector &attr_vector,
@@ -59,6 +77,11 @@ class   XMLParser : public XERCES_CPP_NAMESPACE::HandlerBase  {
         void error (const SAXParseException &exception) throw ();
         void fatalError (const SAXParseException &exception) throw ();
 
+       // SAX EntityResolver interface
+       //
+        InputSource *resolveEntity (const XMLCh *const public_id,
+                                    const XMLCh *const system_id);
+
     public:
 
         std::ostream &dumpForm (std::ostream &os = std::cout) const;
@@ -94,6 +117,18 @@ class   XMLParser : public XERCES_CPP_NAMESPACE::HandlerBase  {
             return (fatal_error_);
         }
 
+       // Attaches a statistics object that accumulates counters and timings
+       // of the following parses. Pass NULL to detach it.
+       //
+       // NOTE: Statistics are only collected, if the library is built with
+       //       XMLPARSER_STATS defined (see XMLParseStats.h).
+       //
+        inline void set_stats (XMLParseStats *stats) throw ()  {
+
+            stats_ = stats;
+        }
+        inline XMLParseStats *get_stats () const throw ()  { return (stats_); }
+
     private:
 
         std::stack<XMLTreeNodes *,
@@ -101,6 +136,29 @@ class   XMLParser : public XERCES_CPP_NAMESPACE::HandlerBase  {
 
         bool                            has_problem_;
         bool                            started_;
+        bool                            low_latency_;
+        bool                            threaded_input_;
+        FileInput                       file_input_;
+        std::size_t                     read_ahead_size_;
+        XMLParseStats::counter_type     input_stall_ns_;
+
+       // The settings of the pooled SAX parser before set_low_latency_mode()
+       // changed them. The destructor puts them back, so the next user of
+       // the pooled parser doesn't inherit the mode.
+       //
+        class   ScannerSettings_  {
+
+            public:
+
+                SAXParser::ValSchemes   validation_scheme;
+                bool                    do_schema;
+                bool                    full_checking;
+                bool                    load_external_dtd;
+                bool                    calculate_src_ofs;
+                bool                    exit_on_first_fatal_error;
+        };
+
+        ScannerSettings_                saved_settings_;
 
         XMLTreeNodes                *just_closed_element_;
         XMLTreeNodes                *just_opened_element_;
@@ -111,17 +169,217 @@ class   XMLParser : public XERCES_CPP_NAMESPACE::HandlerBase  {
         XmlErrorVector                  error_msgs_;
         std::string                     fatal_error_;
 
+       // Nodes and attribute buffers of previous documents, kept around to
+       // be recycled by the next document. They are stored in reverse
+       // document order, so that taking them from the back hands out the
+       // same buffers to the same positions in similarly shaped documents.
+       //
+        std::vector<XMLTreeNodes *>     node_pool_;
+        XMLTreeNodes::attr_vector       attr_pool_;
+
+        void recycle_tree_ ();
+
+       // The next node of the document: the initial node, a recycled node
+       // or a new one
+       //
+        template<typename xml_CHAR>
+        XMLTreeNodes *new_node_ (const xml_CHAR *const name,
+                                 size_type attr_size);
+
+       // Wraps raw_cb with decompression and, if asked for, a read-ahead
+       // thread
+       //
+        XMLReadCallback make_reader_ (
+            const XMLReadCallback &raw_cb,
+            bool read_ahead,
+            const std::shared_ptr<XMLReadCanceller> &canceller =
+                std::shared_ptr<XMLReadCanceller> ());
+
+       // The same over fd. With a reader thread, the fd reads can be
+       // cancelled, so a parse that stops early doesn't wait for a pipe or
+       // a socket that has nothing more to say.
+       //
+        XMLReadCallback make_fd_reader_ (int fd,
+                                         std::size_t will_need,
+                                         bool read_ahead);
+
+       // The statistics object and the per document time spent in our
+       // handlers and, as part of that, in transcoding.
+       //
+        XMLParseStats               *stats_;
+        XMLParseStats::counter_type handler_ns_;
+        XMLParseStats::counter_type transcoding_ns_;
+
+       // With statistics on, names and values are transcoded into these
+       // first, so that the transcoding can be timed on its own
+       //
+        std::string                 name_buffer_;
+        std::string                 value_buffer_;
+
+        const char *transcode_ (const XMLCh *const str,
+                                std::string &buffer) throw ();
+
+        XMLParseStats::counter_type start_stats_ () throw ();
+        void end_stats_ (XMLParseStats::counter_type start_ns,
+                         XMLParseStats::counter_type bytes_consumed) throw ();
+
     public:
 
+       // Discards the last parsed document, so this object can parse a new
+       // one into the same initial node and attribute vector. All nodes,
+       // names and attribute buffers of the old document are kept and
+       // recycled by the next parse, instead of being freed.
+       // In steady state, parsing documents of similar shape does not
+       // allocate any memory on our side.
+       //
+       // NOTE: The parse methods call reset() themselves, if a document
+       //       was already parsed.
+       //
+        void reset ();
+
+       // Tunes this parser for tail latency of small (a few KB) documents
+       // that are parsed with parse_string() over and over. It turns off
+       // validation, schema processing and loading of external DTDs, so
+       // none of that machinery is touched per parse.
+       // Combined with the tree recycling of reset(), a parse_string() call
+       // does no memory allocation on our side in steady state.
+       // The pooled SAX parser gets its old settings back, when this object
+       // is destroyed.
+       //
+        void set_low_latency_mode ();
+        inline bool is_low_latency_mode () const throw ()  {
+
+            return (low_latency_);
+        }
+
+       // xml_len is a std::size_t, so documents over 4 GB are not
+       // truncated
+       //
         bool parse_string (const char *const xml,
-                           size_type xml_len,
+                           std::size_t xml_len,
                            const char *const sys_id);
-        inline bool parse_string (const char *const xml, size_type xml_len)  {
+        inline bool
+        parse_string (const char *const xml, std::size_t xml_len)  {
 
             return (parse_string (xml, xml_len, "default"));
         }
         bool parse_file (const char *const file);
 
+       // How parse_file() reads its file:
+       //
+       // fi_xerces: The file is read on the parsing thread, as Xerces asks
+       //     for more input. This is the default. Xerces opens by itself
+       //     only what can't be opened as a file, e.g. a URL.
+       // fi_read_ahead: A reader thread fills two buffers of buffer_size
+       //     bytes in turn, with posix_fadvise() hints, while the parser
+       //     consumes the other one. Use it where mmap() is not wanted, or
+       //     the file is on a network file system or is a named pipe.
+       //
+       // buffer_size is also the read ahead buffer size of the threaded
+       // input below.
+       //
+        void set_file_input (FileInput strategy,
+                             std::size_t buffer_size = 1024 * 1024);
+        inline FileInput get_file_input () const throw ()  {
+
+            return (file_input_);
+        }
+
+       // The nanoseconds the last parse spent waiting for input from a
+       // reader thread (fi_read_ahead or threaded input). It tells whether
+       // parsing is I/O bound.
+       //
+        inline XMLParseStats::counter_type input_stall_ns () const throw ()  {
+
+            return (input_stall_ns_);
+        }
+
+       // Streaming parses:
+       //
+       // These pull the document through Xerces' fixed size raw buffer, as
+       // the parse goes. Unlike parse_string(), the whole document never
+       // has to be in memory, so the memory used for input stays constant,
+       // no matter how large the document is. The tree is still built as
+       // usual.
+       //
+       // parse_callback() reads through read_cb (see XMLInputSources.h).
+       // parse_stream() reads from an std::istream, e.g. std::cin. parse_fd()
+       // reads from a file descriptor, e.g. a pipe or a socket. Neither
+       // closes its input.
+       //
+       // parse_stream(), parse_fd() and parse_file() detect gzip and zstd
+       // compressed input by its magic bytes and decompress it on the fly
+       // (see XMLmake_decompress_reader()). parse_callback() reads its input
+       // as is; wrap read_cb to get the same.
+       //
+        bool parse_callback (const XMLReadCallback &read_cb,
+                             const char *const sys_id = "callback");
+        bool parse_stream (std::istream &is,
+                           const char *const sys_id = "stream");
+        bool parse_fd (int fd, const char *const sys_id = "fd");
+
+       // If on, the above streaming parses and parse_file() read and
+       // decompress their input on a separate thread, so it overlaps with
+       // parsing (see XMLmake_prefetch_reader()).
+       // It defaults to off.
+       // If a parse stops early, e.g. on a fatal error, a read of the
+       // thread that is blocked on a pipe or a socket is cancelled. A read
+       // of parse_stream() can't be cancelled, so it is waited for.
+       //
+        inline void set_threaded_input (bool on) throw ()  {
+
+            threaded_input_ = on;
+        }
+        inline bool is_threaded_input () const throw ()  {
+
+            return (threaded_input_);
+        }
+
+       // Grammar caching:
+       //
+       // All pooled SAX parsers share one grammar pool. A DTD or schema that
+       // is preloaded into the pool is compiled once per process, and every
+       // validating parse that refers to it (by system_id) uses the cached
+       // grammar instead of reading and compiling it again.
+       //
+       // preload_grammar() reads local_file once, registers it as the local
+       // copy of system_id (see register_local_entity()) and compiles it
+       // into the grammar pool. It returns false, if the grammar could not
+       // be built.
+       //
+       // lock_grammar_pool() makes the pool read-only. After that, no more
+       // grammars can be preloaded and the pool is safe to be used by any
+       // number of threads.
+       //
+       // NOTE: Preload all grammars before parsing starts.
+       //
+        static bool preload_grammar (const char *const system_id,
+                                     const char *const local_file,
+                                     GrammarType grammar_type =
+                                         XERCES_CPP_NAMESPACE::Grammar::
+                                             DTDGrammarType);
+        static void lock_grammar_pool ();
+
+       // Registers local_file as the content of the external entity (DTD,
+       // schema, ...) identified by system_id. The file is read once and
+       // kept in memory. From then on, every XMLParser resolves system_id
+       // from memory instead of going to the file system or network.
+       // Registering system_id again replaces its content for the parses
+       // that start afterwards. The old content is kept for the parses
+       // that may still be reading it.
+       //
+        static void register_local_entity (const char *const system_id,
+                                           const char *const local_file);
+
+       // The memory manager of the SAX parser used by this object. Its
+       // counters cover the last parse.
+       //
+        inline const XMLArenaMemoryManager &
+        memory_manager () const throw ()  {
+
+            return (*(my_parser_strap_.mem_manager));
+        }
+
     private:
 
        // Creating and destroying SAXParser objects on the stack
@@ -131,9 +389,18 @@ class   XMLParser : public XERCES_CPP_NAMESPACE::HandlerBase  {
 
             public:
 
-                inline ParserStrap (SAXParser *p, bool b) throw ()
-                    : parser (p), busy (b)  {   }
-                inline ~ParserStrap () throw ()  { delete parser; }
+                inline ParserStrap (SAXParser *p,
+                                    XMLArenaMemoryManager *mm,
+                                    bool b) throw ()
+                    : parser (p), mem_manager (mm), busy (b)  {   }
+
+               // The parser must go before its memory manager
+               //
+                inline ~ParserStrap () throw ()  {
+
+                    delete parser;
+                    delete mem_manager;
+                }
 
                 inline bool
                 operator == (const ParserStrap &rhs) const throw ()  {
@@ -141,8 +408,9 @@ class   XMLParser : public XERCES_CPP_NAMESPACE::HandlerBase  {
                     return (parser == rhs.parser);
                 }
 
-                SAXParser   *parser;
-                bool        busy;
+                SAXParser               *parser;
+                XMLArenaMemoryManager   *mem_manager;
+                bool                    busy;
 
             private:
 
@@ -157,6 +425,25 @@ class   XMLParser : public XERCES_CPP_NAMESPACE::HandlerBase  {
         typedef DMScu_PtrVector<ParserStrap>    ParserVector;
 
         static  ParserVector    parser_cache_;
+        static  std::mutex      parser_cache_mutex_;
+
+       // The grammar pool shared by all pooled SAX parsers
+       //
+        static  XERCES_CPP_NAMESPACE::XMLGrammarPool    *grammar_pool_;
+
+       // System id -> content of the locally registered external entities.
+       // The contents live in local_contents_ and are never freed, not even
+       // when a system id is registered again. A parse may still be reading
+       // the old content through a MemBufInputSource.
+       //
+        typedef std::map<std::string, const std::string *>  EntityMap;
+
+        static  EntityMap               local_entities_;
+        static  std::list<std::string>  local_contents_;
+        static  std::mutex              local_entities_mutex_;
+
+        static const std::string &read_local_entity_ (const char *const sys_id,
+                                                      const char *const file);
 
        // If there is a SAX parser available, return it. Otherwise
        // create a new sax parser object and add it to the cache.
@@ -168,6 +455,13 @@ class   XMLParser : public XERCES_CPP_NAMESPACE::HandlerBase  {
        //
         ParserStrap   &my_parser_strap_;
 
+       // The input source of parse_string() is bound once and pointed at
+       // the new buffer for each parse. It doesn't copy or adopt the buffer.
+       // It allocates from the arena of the pooled parser, so the destructor
+       // destroys it before the pooled parser is released.
+       //
+        std::unique_ptr<XMLMemBufInputSource>   mem_buf_;
+
        // Initializes the static SAX parser stuff
        //
         class   PP_Initializer  {
@@ -151,6 +151,48 @@ class   XMLString  {
             return (len);
         }
 
+       // Returns true, if str is all 7-bit ASCII. In the same pass, len is
+       // set to the number of characters in str.
+       //
+        static inline bool
+        ascii_len (const value_type *const str, size_type &len) throw ()  {
+
+            value_type  bits = 0;
+
+            len = 0;
+            for (const value_type *iter = str; *iter; ++iter, ++len)
+                bits |= *iter;
+
+            return (bits < 0x80);
+        }
+
+       // Copies the first len characters of an all ASCII str to the char
+       // buffer to_fill, and null terminates it. to_fill must have room for
+       // len + 1 chars. This is a lot faster than going through the Xerces
+       // transcoder, and the result is the same for ASCII.
+       //
+        static inline void narrow_ascii (const value_type *const str,
+                                         char *const to_fill,
+                                         size_type len) throw ()  {
+
+            for (size_type i = 0; i < len; ++i)
+                to_fill [i] = static_cast<char>(str [i]);
+            to_fill [len] = 0;
+        }
+
+       // Decodes, in place, the predefined entity references (&lt; &gt;
+       // &amp; &quot; &apos;) and the character references (&#N; &#xN;,
+       // written out as UTF-8) in the first len chars of str. Anything that
+       // is not a well formed reference is left alone.
+       // It returns the new length and null terminates str, so str must
+       // have room for len + 1 chars.
+       //
+       // NOTE: Xerces already does this to everything it hands to
+       //       XMLParser. This is for raw XML text that didn't go through
+       //       Xerces.
+       //
+        static size_type decode_references (char *const str, size_type len);
+
         std::string to_stdstring ();
 
        // NOTE: In this version, the caller is responsible to delete[] result.
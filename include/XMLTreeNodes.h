@@ -7,14 +7,18 @@
 #define _INCLUDED_XMLTreeNodes_h 0
 
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <iterator>
 
 #include <string>
 #include <vector>
 #include <utility>
 
+#include <XMLEscape.h>
 #include <XMLString.h>
 #include <XMLNVPair.h>
+#include <XMLTypedValue.h>
 
 // ----------------------------------------------------------------------------
 
@@ -47,6 +51,10 @@ namespace hmxml
 //   5) It has a dump_xml() method that reproduces a syntactically correct
 //      XML statement, identical to the statement that was parsed to
 //      build this tree.
+//   6) It provides pre-order, post-order and level-order iterators over
+//      a node and all its descendants, with the same properties as 4).
+//      For that, every node also knows its parent. The level-order one
+//      keeps its state in a queue the caller provides.
 //
 class   XMLTreeNodes  {
 
@@ -65,6 +73,7 @@ class   XMLTreeNodes  {
         char                *name_;
         XMLTreeNodes    *child_;
         XMLTreeNodes    *sibling_;
+        XMLTreeNodes    *parent_;
         attr_vector         &attr_list_;
         size_type           attr_starting_point_;
         size_type           attr_size_;
@@ -75,15 +84,17 @@ class   XMLTreeNodes  {
             : name_ (NULL),
               child_ (NULL),
               sibling_ (NULL),
+              parent_ (NULL),
               attr_list_ (attr_list),
               attr_starting_point_ (attr_list.size ()),
               attr_size_ (0)  {    }
         inline XMLTreeNodes (XMLNVPair::ConstStrType name,
                                  size_type attr_size,
                                  attr_vector &attr_list) throw ()
-            : child_ (NULL),
+            : name_ (NULL),
+              child_ (NULL),
               sibling_ (NULL),
-              name_ (NULL),
+              parent_ (NULL),
               attr_list_ (attr_list),
               attr_starting_point_ (attr_list.size ()),
               attr_size_ (attr_size)  {
@@ -93,38 +104,25 @@ class   XMLTreeNodes  {
         inline XMLTreeNodes (const XMLCh *const name,
                                  size_type attr_size,
                                  attr_vector &attr_list) throw ()
-            : child_ (NULL),
+            : name_ (NULL),
+              child_ (NULL),
               sibling_ (NULL),
-              name_ (NULL),
+              parent_ (NULL),
               attr_list_ (attr_list),
               attr_starting_point_ (attr_list.size ()),
               attr_size_ (attr_size)  {
 
             set_name (name);
         }
+       // A node owns its child and its sibling, so this deletes the whole
+       // tree under and after this node. It doesn't recurse and uses no
+       // extra memory, no matter how deep or wide the tree is.
+       //
         inline ~XMLTreeNodes () throw ()  {
 
-            typedef std::vector<XMLTreeNodes *> VecType;
-
             delete[] name_;
-            delete child_;
-
-            XMLTreeNodes::iterator itr = sibling_begin ();
-
-            if (itr != child_sibling_end ())  {
-                VecType vec;
-
-                vec.reserve (1024);
-                for ( ; itr != child_sibling_end (); ++itr)
-                    vec.push_back (const_cast<XMLTreeNodes *>(&(*itr)));
-
-                for (VecType::reverse_iterator ritr = vec.rbegin ();
-                     ritr != vec.rend (); ++ritr)  {
-                    delete (*ritr)->sibling_;
-                    (*ritr)->sibling_ = NULL;
-                }
-                delete sibling_;
-            }
+            delete_chain_ (child_);
+            delete_chain_ (sibling_);
         }
 
         inline void set_attr_size (size_type attr_size) throw ()  {
@@ -154,22 +152,73 @@ class   XMLTreeNodes  {
 
         inline void set_name (const XMLCh *const name_in) throw ()  {
 
-            delete[] name_;
-            name_ = XERCES_CPP_NAMESPACE::XMLString::transcode (name_in);
+            XMLString::size_type    nilen = 0;
+            const   bool            is_ascii =
+                XMLString::ascii_len (name_in, nilen);
+
+            if (! is_ascii)
+                nilen = XMLString::charstar_len (name_in);
+
+            if (name_ == NULL || nilen > ::strlen (name_))  {
+                delete[] name_;
+                name_ = new char [nilen + 1];
+            }
+
+            if (is_ascii)
+                XMLString::narrow_ascii (name_in, name_, nilen);
+            else
+                XERCES_CPP_NAMESPACE::XMLString::transcode (name_in, name_,
+                                                            nilen);
+            return;
+        }
+
+       // Re-initializes this node, so it can be reused for a new document.
+       // The name buffer is kept and reused, if it is large enough.
+       //
+       // NOTE: The caller must have already detached (and taken care of)
+       //       the child and sibling of this node.
+       //
+        inline void recycle (const XMLCh *const name,
+                             size_type attr_size) throw ()  {
+
+            child_ = NULL;
+            sibling_ = NULL;
+            parent_ = NULL;
+            attr_starting_point_ = attr_list_.size ();
+            attr_size_ = attr_size;
+            set_name (name);
+            return;
+        }
+        inline void recycle (XMLNVPair::ConstStrType name,
+                             size_type attr_size) throw ()  {
+
+            child_ = NULL;
+            sibling_ = NULL;
+            parent_ = NULL;
+            attr_starting_point_ = attr_list_.size ();
+            attr_size_ = attr_size;
+            set_name (name);
             return;
         }
 
        // NOTE: If the user sets either child or sibling twice without
        //       deleting the first child or sibling, there will be a
        //       memory leak.
+       //
+       // These also make this node, or its parent, the parent of the new
+       // child or sibling and of the siblings that follow it.
        //
         inline void set_child (XMLTreeNodes *child) throw ()  {
 
             child_ = child;
+            for ( ; child != NULL; child = child->sibling_)
+                child->parent_ = this;
         }
         inline void set_sibling (XMLTreeNodes *sibling) throw ()  {
 
             sibling_ = sibling;
+            for ( ; sibling != NULL; sibling = sibling->sibling_)
+                sibling->parent_ = parent_;
         }
 
         inline const XMLTreeNodes *get_child () const throw ()  {
@@ -183,6 +232,14 @@ class   XMLTreeNodes  {
         inline XMLTreeNodes *get_child () throw ()  { return (child_); }
         inline XMLTreeNodes *get_sibling () throw () { return (sibling_); }
 
+       // The parent is NULL for the root node and its siblings
+       //
+        inline const XMLTreeNodes *get_parent () const throw ()  {
+
+            return (parent_);
+        }
+        inline XMLTreeNodes *get_parent () throw ()  { return (parent_); }
+
         inline void add_attr (XMLNVPair::ConstStrType name,
                               XMLNVPair::ConstStrType value) throw ()  {
 
@@ -209,6 +266,35 @@ class   XMLTreeNodes  {
             attr_list_.back ().set_name_value (name, value);
             return;
         } 
+
+       // Same as above, but the name/value buffer is taken from the back of
+       // spares, if there is one. This is used to recycle the attribute
+       // storage of a previous document.
+       //
+        inline void add_attr (const XMLCh *const name,
+                              const XMLCh *const value,
+                              attr_vector &spares) throw () {
+
+            attr_list_.push_back (XMLNVPair());
+            if (! spares.empty ())  {
+                attr_list_.back ().swap (spares.back ());
+                spares.pop_back ();
+            }
+            attr_list_.back ().set_name_value (name, value);
+            return;
+        }
+        inline void add_attr (XMLNVPair::ConstStrType name,
+                              XMLNVPair::ConstStrType value,
+                              attr_vector &spares) throw () {
+
+            attr_list_.push_back (XMLNVPair());
+            if (! spares.empty ())  {
+                attr_list_.back ().swap (spares.back ());
+                spares.pop_back ();
+            }
+            attr_list_.back ().set_name_value (name, value);
+            return;
+        }
         inline XMLNVPair::ConstStrType
         get_attr (XMLNVPair::ConstStrType name) const throw ()  {
 
@@ -228,61 +314,146 @@ class   XMLTreeNodes  {
             return (attr_list_ [attr_starting_point_ + index].get_value ());
         }
 
+       // Converts the value of the attribute to T, which may be an integer
+       // type, float, double, bool or XMLTimeStamp. value is left alone,
+       // unless it returns xcs_ok. See XMLTypedValue.h
+       //
+        template<typename T>
+        inline XMLConvStatus
+        get_attr_as (XMLNVPair::ConstStrType name, T &value) const throw ()  {
+
+            return (XMLconvert (get_attr (name), value));
+        }
+
+       // Memory accounting:
+       //
+       // bytes_used() returns the bytes taken by this node and all its
+       // descendants (not its siblings): the node objects, their names and
+       // the name/value buffers of their attributes.
+       // The attribute vector is shared by all nodes of a tree, so its
+       // slots (including the unused capacity) are accounted for separately
+       // by attr_vector_bytes().
+       //
+       // NOTE: The per block overhead of the heap allocator is not included.
+       //
+        inline std::size_t bytes_used () const  {
+
+            std::vector<const XMLTreeNodes *>   stack;
+            std::size_t                         bytes = 0;
+            const   XMLTreeNodes                *node = this;
+
+            while (node != NULL)  {
+                bytes += sizeof (XMLTreeNodes);
+                if (node->name_ != NULL)
+                    bytes += ::strlen (node->name_) + 1;
+                for (attr_const_iterator itr = node->attr_begin ();
+                     itr != node->attr_end (); ++itr)
+                    bytes += itr->heap_bytes ();
+
+                if (node->sibling_ != NULL && node != this)
+                    stack.push_back (node->sibling_);
+
+                if (node->child_ != NULL)
+                    node = node->child_;
+                else if (! stack.empty ())  {
+                    node = stack.back ();
+                    stack.pop_back ();
+                }
+                else
+                    node = NULL;
+            }
+
+            return (bytes);
+        }
+
+        static inline std::size_t
+        attr_vector_bytes (const attr_vector &attrs) throw ()  {
+
+            return (attrs.capacity () * sizeof (XMLNVPair));
+        }
+        static inline std::size_t
+        attr_vector_slack_bytes (const attr_vector &attrs) throw ()  {
+
+            return ((attrs.capacity () - attrs.size ()) * sizeof (XMLNVPair));
+        }
+
+       // The layouts that dump_xml() can produce into a string:
+       //
+       //   df_lines:    One element per line, with its attributes on the
+       //                same line. This is the default.
+       //   df_indented: The same as dump_xml (std::ostream &). Elements
+       //                are indented by depth and every attribute is on a
+       //                line of its own.
+       //   df_compact:  No line breaks or indentation at all
+       //
+        enum DumpFormat  { df_lines, df_indented, df_compact };
+
        // Currently the assumption is that 'prefix' is one or more
        // SPACE character(s).
        //
        // It must produce a syntactically correct XML statement that is
-       // identical to the one that was parsed to build this tree.
+       // identical to the one that was parsed to build this tree. Attribute
+       // values are escaped, so they parse back to the same values (though
+       // a reference may be spelled differently than in the original).
+       //
+       // Both dump this node, its descendants and its siblings (and
+       // theirs). They don't recurse. The only extra memory is a stack of
+       // the open elements, which is as deep as the tree.
        //
         inline std::ostream &
         dump_xml (std::ostream &os, const char *const prefix = "") const  {
 
-            const   std::string pf = prefix;
+            StreamSink_                         sink = { os };
+            std::vector<const XMLTreeNodes *>   open;
 
-            os << pf << "<" << name_ << "\n";
+            dump_ (sink, df_indented, ::strlen (prefix), open);
+            return (os);
+        }
 
-            const   std::string pf2 = pf + "    ";
+       // The string is appended to, and grows only once. The exact size of
+       // the output is counted first, and then the pieces are copied in.
+       //
+        inline std::string &
+        dump_xml (std::string &str, DumpFormat format = df_lines) const  {
 
-            dump_attr (os, pf2.c_str ());
+            SizeSink_                           size = { 0 };
+            std::vector<const XMLTreeNodes *>   open;
 
-            if (child_ == NULL)
-                os << pf << "/>\n";
-            else  {
-                os << pf << ">\n";
+            dump_ (size, format, 0, open);
 
-                const   std::string pf3 = pf + "  ";
+            const   std::string::size_type  start = str.size ();
 
-                child_->dump_xml (os, pf3.c_str ());
-                os << pf << "</" << name_ << ">\n";
-            }
+            str.resize (start + size.bytes);
 
-            if (sibling_ != NULL)
-                 sibling_->dump_xml (os, pf.c_str ());
+            CopySink_   copy = { &(str [0]) + start };
 
-            return (os);
+            dump_ (copy, format, 0, open);
+            return (str);
         }
-        inline std::string &dump_xml (std::string &str) const  {
 
-            str += "<";
-            str += name_;
-            str += " ";
+       // Dumps into a sink, such as XMLIovecSink, that has put (const
+       // char *, std::size_t), put (const char *), put_escaped (const char
+       // *) and spaces (std::size_t)
+       //
+        template<typename xml_SINK>
+        inline xml_SINK &
+        dump_to_sink (xml_SINK &sink, DumpFormat format = df_lines) const  {
 
-            dump_attr (str);
+            std::vector<const XMLTreeNodes *>   open;
 
-            if (child_ == NULL)
-                str += "/>\n";
-            else  {
-                str += ">\n";
-                child_->dump_xml (str);
-                str += "</";
-                str += name_;
-                str += ">\n";
-            }
+            dump_ (sink, format, 0, open);
+            return (sink);
+        }
 
-            if (sibling_ != NULL)
-                 sibling_->dump_xml (str);
+       // The number of chars that dump_xml (std::string &) appends
+       //
+        inline std::size_t dump_size (DumpFormat format = df_lines) const  {
 
-            return (str);
+            SizeSink_                           size = { 0 };
+            std::vector<const XMLTreeNodes *>   open;
+
+            dump_ (size, format, 0, open);
+            return (size.bytes);
         }
 
         inline std::ostream &
@@ -453,6 +624,378 @@ class   XMLTreeNodes  {
                 XMLTreeNodes    const   *node_;
         };
 
+       // Whole tree iterators:
+       //
+       // These walk a node and all of its descendants (not its siblings).
+       // They follow the child, sibling and parent links, so they don't
+       // recurse, don't allocate and, like const_iterator, are cheap to
+       // copy around. They also keep the depth of the current node, which
+       // is 0 for the node the walk started from.
+       //
+       // NOTE: The tree must not be changed while it is walked.
+       //
+
+       // Pre-order: a node comes before its descendants, and they come
+       // before its next sibling.
+       // If it is asked for exit events, it also stops at every node after
+       // all its descendants, with event() returning te_exit. That is, it
+       // visits the tree the way a SAX parser or XMLCursor reports it.
+       //
+        enum TraversalEvent  {
+            te_enter = 0,
+            te_exit = 1
+        };
+
+        class   const_preorder_iterator  {
+
+            public:
+
+                typedef std::forward_iterator_tag   iterator_category;
+                typedef XMLTreeNodes                value_type;
+                typedef std::ptrdiff_t              difference_type;
+                typedef const XMLTreeNodes          *pointer;
+                typedef const XMLTreeNodes          &reference;
+
+               // NOTE: The constructor with no argument initializes
+               //       the iterator to be the "end" iterator
+               //
+                inline const_preorder_iterator () throw ()
+                    : node_ (NULL), root_ (NULL), depth_ (0),
+                      exit_events_ (false), exiting_ (false)  {   }
+                inline explicit
+                const_preorder_iterator (const XMLTreeNodes *root,
+                                         bool exit_events = false) throw ()
+                    : node_ (root), root_ (root), depth_ (0),
+                      exit_events_ (exit_events), exiting_ (false)  {   }
+
+                inline bool
+                operator == (const const_preorder_iterator &rhs)
+                    const throw ()  {
+
+                    return (node_ == rhs.node_ && exiting_ == rhs.exiting_);
+                }
+                inline bool
+                operator != (const const_preorder_iterator &rhs)
+                    const throw ()  {
+
+                    return (! (*this == rhs));
+                }
+
+                inline const XMLTreeNodes *operator -> () const throw ()  {
+
+                    return (node_);
+                }
+                inline const XMLTreeNodes &operator * () const throw ()  {
+
+                    return (*node_);
+                }
+
+                inline size_type depth () const throw ()  { return (depth_); }
+                inline TraversalEvent event () const throw ()  {
+
+                    return (exiting_ ? te_exit : te_enter);
+                }
+
+                inline const_preorder_iterator &operator ++ () throw ()  {
+
+                    if (! exiting_ && node_->child_ != NULL)  {
+                        node_ = node_->child_;
+                        depth_ += 1;
+                        return (*this);
+                    }
+                    if (! exiting_ && exit_events_)  {  // Leaf node
+                        exiting_ = true;
+                        return (*this);
+                    }
+
+                   // Done with node_ and its descendants
+                   //
+                    for (;;)  {
+                        if (node_ == root_)  {
+                            node_ = NULL;
+                            exiting_ = false;
+                            break;
+                        }
+                        if (node_->sibling_ != NULL)  {
+                            node_ = node_->sibling_;
+                            exiting_ = false;
+                            break;
+                        }
+                        node_ = node_->parent_;
+                        depth_ -= 1;
+                        if (exit_events_)  {
+                            exiting_ = true;
+                            break;
+                        }
+                    }
+
+                    return (*this);
+                }
+                inline const_preorder_iterator operator ++ (int) throw ()  {
+
+                    const_preorder_iterator ret = *this;
+
+                    ++(*this);
+                    return (ret);
+                }
+
+            private:
+
+                const   XMLTreeNodes    *node_;
+                const   XMLTreeNodes    *root_;
+                size_type               depth_;
+                bool                    exit_events_;
+                bool                    exiting_;
+        };
+
+       // Post-order: a node comes after its descendants, which come after
+       // its previous siblings and their descendants.
+       //
+        class   const_postorder_iterator  {
+
+            public:
+
+                typedef std::forward_iterator_tag   iterator_category;
+                typedef XMLTreeNodes                value_type;
+                typedef std::ptrdiff_t              difference_type;
+                typedef const XMLTreeNodes          *pointer;
+                typedef const XMLTreeNodes          &reference;
+
+                inline const_postorder_iterator () throw ()
+                    : node_ (NULL), root_ (NULL), depth_ (0)  {   }
+                inline explicit
+                const_postorder_iterator (const XMLTreeNodes *root) throw ()
+                    : node_ (root), root_ (root), depth_ (0)  {
+
+                    if (node_ != NULL)
+                        descend_ ();
+                }
+
+                inline bool
+                operator == (const const_postorder_iterator &rhs)
+                    const throw ()  {
+
+                    return (node_ == rhs.node_);
+                }
+                inline bool
+                operator != (const const_postorder_iterator &rhs)
+                    const throw ()  {
+
+                    return (node_ != rhs.node_);
+                }
+
+                inline const XMLTreeNodes *operator -> () const throw ()  {
+
+                    return (node_);
+                }
+                inline const XMLTreeNodes &operator * () const throw ()  {
+
+                    return (*node_);
+                }
+
+                inline size_type depth () const throw ()  { return (depth_); }
+
+                inline const_postorder_iterator &operator ++ () throw ()  {
+
+                    if (node_ == root_)
+                        node_ = NULL;
+                    else if (node_->sibling_ != NULL)  {
+                        node_ = node_->sibling_;
+                        descend_ ();
+                    }
+                    else  {
+                        node_ = node_->parent_;
+                        depth_ -= 1;
+                    }
+
+                    return (*this);
+                }
+                inline const_postorder_iterator operator ++ (int) throw ()  {
+
+                    const_postorder_iterator    ret = *this;
+
+                    ++(*this);
+                    return (ret);
+                }
+
+            private:
+
+                const   XMLTreeNodes    *node_;
+                const   XMLTreeNodes    *root_;
+                size_type               depth_;
+
+               // Goes down to the first leaf under node_
+               //
+                inline void descend_ () throw ()  {
+
+                    for ( ; node_->child_ != NULL; depth_ += 1)
+                        node_ = node_->child_;
+                }
+        };
+
+        class   const_level_iterator;
+
+       // The queue of a level-order walk. It holds the first child of each
+       // node whose children are yet to be walked, so it grows to about
+       // the width of the widest level. It can be reused for many walks,
+       // and once it is big enough (see reserve()), they don't allocate.
+       //
+        class   level_queue  {
+
+            public:
+
+                inline level_queue () throw () : head_ (0), size_ (0)  {   }
+
+                inline void reserve (size_type capacity)  {
+
+                    while (nodes_.size () < capacity)
+                        grow_ ();
+                }
+
+            private:
+
+                friend  class   const_level_iterator;
+
+               // A ring whose size is a power of 2
+               //
+                std::vector<const XMLTreeNodes *>   nodes_;
+                size_type                           head_;
+                size_type                           size_;
+
+                inline void clear () throw ()  { head_ = size_ = 0; }
+                inline bool empty () const throw ()  { return (size_ == 0); }
+
+                inline void push (const XMLTreeNodes *node)  {
+
+                    if (size_ == nodes_.size ())
+                        grow_ ();
+                    nodes_ [(head_ + size_) & (nodes_.size () - 1)] = node;
+                    size_ += 1;
+                }
+                inline const XMLTreeNodes *pop () throw ()  {
+
+                    const   XMLTreeNodes    *node = nodes_ [head_];
+
+                    head_ = (head_ + 1) & (nodes_.size () - 1);
+                    size_ -= 1;
+                    return (node);
+                }
+
+                inline void grow_ ()  {
+
+                    std::vector<const XMLTreeNodes *>   bigger (
+                        nodes_.empty () ? 16 : nodes_.size () * 2);
+
+                    const   size_type   mask = nodes_.size () - 1;
+
+                    for (size_type i = 0; i < size_; ++i)
+                        bigger [i] = nodes_ [(head_ + i) & mask];
+                    nodes_.swap (bigger);
+                    head_ = 0;
+                }
+        };
+
+       // Level-order (breadth first): the nodes at depth 0, then the ones
+       // at depth 1 from left to right, and so on.
+       // It walks each list of siblings in turn, and queues the first child
+       // of every node it passes, so a whole walk is O(nodes).
+       //
+       // NOTE: The queue is shared by the copies of an iterator, so only
+       //       one of them can be advanced. That makes it an input
+       //       iterator.
+       //
+        class   const_level_iterator  {
+
+            public:
+
+                typedef std::input_iterator_tag     iterator_category;
+                typedef XMLTreeNodes                value_type;
+                typedef std::ptrdiff_t              difference_type;
+                typedef const XMLTreeNodes          *pointer;
+                typedef const XMLTreeNodes          &reference;
+
+                inline const_level_iterator () throw ()
+                    : node_ (NULL), root_ (NULL), queue_ (NULL), depth_ (0),
+                      left_in_level_ (0), in_next_level_ (0)  {   }
+                inline
+                const_level_iterator (const XMLTreeNodes *root,
+                                      level_queue &queue)
+                    : node_ (root), root_ (root), queue_ (&queue), depth_ (0),
+                      left_in_level_ (0), in_next_level_ (0)  {
+
+                    queue_->clear ();
+                    if (node_ != NULL)
+                        queue_children_ ();
+                }
+
+                inline bool
+                operator == (const const_level_iterator &rhs) const throw ()  {
+
+                    return (node_ == rhs.node_);
+                }
+                inline bool
+                operator != (const const_level_iterator &rhs) const throw ()  {
+
+                    return (node_ != rhs.node_);
+                }
+
+                inline const XMLTreeNodes *operator -> () const throw ()  {
+
+                    return (node_);
+                }
+                inline const XMLTreeNodes &operator * () const throw ()  {
+
+                    return (*node_);
+                }
+
+                inline size_type depth () const throw ()  { return (depth_); }
+
+                inline const_level_iterator &operator ++ ()  {
+
+                    if (node_ != root_ && node_->sibling_ != NULL)
+                        node_ = node_->sibling_;
+                    else if (queue_->empty ())
+                        node_ = NULL;
+                    else  {
+                        if (left_in_level_ == 0)  {  // Start the next level
+                            depth_ += 1;
+                            left_in_level_ = in_next_level_;
+                            in_next_level_ = 0;
+                        }
+                        left_in_level_ -= 1;
+                        node_ = queue_->pop ();
+                    }
+                    if (node_ != NULL)
+                        queue_children_ ();
+
+                    return (*this);
+                }
+                inline const_level_iterator operator ++ (int)  {
+
+                    const_level_iterator    ret = *this;
+
+                    ++(*this);
+                    return (ret);
+                }
+
+            private:
+
+                const   XMLTreeNodes    *node_;
+                const   XMLTreeNodes    *root_;
+                level_queue             *queue_;
+                size_type               depth_;
+                size_type               left_in_level_;  // Queued at depth_
+                size_type               in_next_level_;  // At depth_ + 1
+
+                inline void queue_children_ ()  {
+
+                    if (node_->child_ != NULL)  {
+                        queue_->push (node_->child_);
+                        in_next_level_ += 1;
+                    }
+                }
+        };
+
        // Iterator related interface.
        //
         inline const_iterator child_begin () const throw ()  {
@@ -468,6 +1011,33 @@ class   XMLTreeNodes  {
             return (our_const_end_node ());
         }
 
+        inline const_preorder_iterator
+        preorder_begin (bool exit_events = false) const throw ()  {
+
+            return (const_preorder_iterator (this, exit_events));
+        }
+        inline const_preorder_iterator preorder_end () const throw ()  {
+
+            return (const_preorder_iterator ());
+        }
+        inline const_postorder_iterator postorder_begin () const throw ()  {
+
+            return (const_postorder_iterator (this));
+        }
+        inline const_postorder_iterator postorder_end () const throw ()  {
+
+            return (const_postorder_iterator ());
+        }
+        inline const_level_iterator
+        level_begin (level_queue &queue) const  {
+
+            return (const_level_iterator (this, queue));
+        }
+        inline const_level_iterator level_end () const throw ()  {
+
+            return (const_level_iterator ());
+        }
+
         inline attr_const_iterator attr_begin () const throw ()  {
 
             return (attr_list_.begin () + attr_starting_point_);
@@ -495,6 +1065,199 @@ class   XMLTreeNodes  {
 
     private:
 
+       // Deletes node, and everything linked to it through its child and
+       // sibling links.
+       // It treats the links as a binary tree (child on the left, sibling
+       // on the right) and rotates it until the node at the top has no
+       // child. That node is then deleted with its links cut, and its
+       // sibling takes its place. Every node is rotated at most once, so
+       // this is linear in the number of nodes.
+       //
+        static inline void delete_chain_ (XMLTreeNodes *node) throw ()  {
+
+            while (node != NULL)  {
+                XMLTreeNodes    *const  child = node->child_;
+
+                if (child != NULL)  {
+                    node->child_ = child->sibling_;
+                    child->sibling_ = node;
+                    node = child;
+                }
+                else  {
+                    XMLTreeNodes    *const  sibling = node->sibling_;
+
+                    node->sibling_ = NULL;
+                    delete node;
+                    node = sibling;
+                }
+            }
+        }
+
+       // The sinks that dump_ () writes to. SizeSink_ only counts.
+       //
+        class   SizeSink_  {
+
+            public:
+
+                std::size_t bytes;
+
+                inline void put (const char *, std::size_t len) throw ()  {
+
+                    bytes += len;
+                }
+                inline void put (const char *str) throw ()  {
+
+                    bytes += ::strlen (str);
+                }
+                inline void spaces (std::size_t count) throw ()  {
+
+                    bytes += count;
+                }
+                inline void put_escaped (const char *str) throw ()  {
+
+                    bytes += XMLescaped_len (str, ::strlen (str));
+                }
+        };
+
+        class   CopySink_  {
+
+            public:
+
+                char    *out;
+
+                inline void put (const char *str, std::size_t len) throw ()  {
+
+                    ::memcpy (out, str, len);
+                    out += len;
+                }
+                inline void put (const char *str) throw ()  {
+
+                    put (str, ::strlen (str));
+                }
+                inline void spaces (std::size_t count) throw ()  {
+
+                    ::memset (out, ' ', count);
+                    out += count;
+                }
+                inline void put_escaped (const char *str) throw ()  {
+
+                    XMLescape (str, ::strlen (str),
+                               [this] (const char *run, std::size_t len)  {
+                                   put (run, len);
+                               });
+                }
+        };
+
+        class   StreamSink_  {
+
+            public:
+
+                std::ostream    &os;
+
+                inline void put (const char *str, std::size_t len)  {
+
+                    os.write (str, len);
+                }
+                inline void put (const char *str)  {
+
+                    put (str, ::strlen (str));
+                }
+                inline void spaces (std::size_t count)  {
+
+                    static  const   char    blanks [] =
+                        "                                ";
+                    const   std::size_t     chunk = sizeof (blanks) - 1;
+
+                    for ( ; count > chunk; count -= chunk)
+                        os.write (blanks, chunk);
+                    os.write (blanks, count);
+                }
+                inline void put_escaped (const char *str)  {
+
+                    XMLescape (str, ::strlen (str),
+                               [this] (const char *run, std::size_t len)  {
+                                   put (run, len);
+                               });
+                }
+        };
+
+       // Writes the XML of this node, its descendants and its siblings into
+       // sink. In df_indented, the lines of an element are indented by
+       // indent plus two spaces per depth, and its attributes by four more.
+       //
+        template<typename xml_SINK>
+        inline void dump_ (xml_SINK &sink,
+                           DumpFormat format,
+                           std::size_t indent,
+                           std::vector<const XMLTreeNodes *> &open) const  {
+
+            const   bool            lines = format != df_compact;
+            const   XMLTreeNodes    *node = this;
+
+            open.clear ();
+            for (;;)  {
+                const   std::size_t pf =
+                    format == df_indented ? indent + 2 * open.size () : 0;
+
+                sink.spaces (pf);
+                sink.put ("<", 1);
+                sink.put (node->name_);
+                if (format == df_indented)
+                    sink.put ("\n", 1);
+                else if (format == df_lines)
+                    sink.put (" ", 1);
+
+                for (attr_const_iterator itr = node->attr_begin ();
+                     itr != node->attr_end (); ++itr)
+                    switch (format)  {
+                        case df_indented:
+                            sink.spaces (pf + 4);
+                            sink.put (itr->get_name ());
+                            sink.put (" = \"", 4);
+                            sink.put_escaped (itr->get_value ());
+                            sink.put ("\"\n", 2);
+                            break;
+                        case df_lines:
+                            sink.put (itr->get_name ());
+                            sink.put ("=\"", 2);
+                            sink.put_escaped (itr->get_value ());
+                            sink.put ("\" ", 2);
+                            break;
+                        case df_compact:
+                            sink.put (" ", 1);
+                            sink.put (itr->get_name ());
+                            sink.put ("=\"", 2);
+                            sink.put_escaped (itr->get_value ());
+                            sink.put ("\"", 1);
+                            break;
+                    }
+
+                sink.spaces (pf);
+                if (node->child_ != NULL)  {
+                    sink.put (">\n", lines ? 2 : 1);
+                    open.push_back (node);
+                    node = node->child_;
+                    continue;
+                }
+                sink.put ("/>\n", lines ? 3 : 2);
+
+               // Close the elements that have no more children
+               //
+                while (node->sibling_ == NULL)  {
+                    if (open.empty ())
+                        return;
+                    node = open.back ();
+                    open.pop_back ();
+                    sink.spaces (format == df_indented
+                                     ? indent + 2 * open.size () : 0);
+                    sink.put ("</", 2);
+                    sink.put (node->name_);
+                    sink.put (">\n", lines ? 2 : 1);
+                }
+                node = node->sibling_;
+            }
+        }
+
        // Inspired by agent 99 in "Get Smart".
        //
         inline static XMLTreeNodes const *our_const_end_node () throw ()  {
@@ -509,6 +1272,9 @@ class   XMLTreeNodes  {
 
         friend  class   const_iterator;
         friend  class   iterator;
+        friend  class   const_preorder_iterator;
+        friend  class   const_postorder_iterator;
+        friend  class   const_level_iterator;
 
     private:
 
@@ -0,0 +1,529 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLTypedValue_h
+#define _INCLUDED_XMLTypedValue_h 0
+
+#include <cerrno>
+#include <cfloat>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <locale.h>
+#include <string>
+#include <type_traits>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// Conversion of attribute values to numbers, booleans and time stamps.
+//
+// The conversions don't depend on the locale, don't allocate and don't
+// throw. They return a status instead. Leading and trailing XML white space
+// is ignored. Anything else that is not part of the value makes it invalid.
+//
+// Integers are plain decimal, with an optional sign. Floating point values
+// that have at most 19 significant digits and a small exponent (that is
+// almost all of them) are converted exactly, without strtod(). The rest go
+// through strtod_l() in the "C" locale.
+// Booleans are "true", "false", "1" and "0", as in XML Schema.
+//
+enum XMLConvStatus  {
+    xcs_ok = 0,
+    xcs_missing = 1,       // There is no such attribute (str is NULL)
+    xcs_invalid = 2,       // The value is not of the asked for type
+    xcs_out_of_range = 3   // The value doesn't fit in the asked for type
+};
+
+// ----------------------------------------------------------------------------
+
+// A date and time in the packed YYYYMMDDhhmmss form, e.g. 20100716083000.
+// A date alone (YYYYMMDD) is taken as its midnight. There is no time zone.
+//
+class   XMLTimeStamp  {
+
+    public:
+
+        unsigned short  year;
+        unsigned char   month;   // 1 - 12
+        unsigned char   day;     // 1 - 31
+        unsigned char   hour;    // 0 - 23
+        unsigned char   minute;  // 0 - 59
+        unsigned char   second;  // 0 - 60 (leap second)
+
+        inline XMLTimeStamp () throw ()
+            : year (0), month (0), day (0), hour (0), minute (0), second (0) {
+        }
+
+       // Back to the YYYYMMDDhhmmss number
+       //
+        inline unsigned long long packed () const throw ()  {
+
+            return (((((year * 100ULL + month) * 100ULL + day) * 100ULL +
+                      hour) * 100ULL + minute) * 100ULL + second);
+        }
+
+       // Seconds since 1970-01-01 00:00:00, taking the time stamp as UTC
+       //
+        inline long long epoch_seconds () const throw ()  {
+
+           // Days from civil (proleptic Gregorian calendar)
+           //
+            const   long long   y = month <= 2 ? year - 1 : year;
+            const   long long   era = (y >= 0 ? y : y - 399) / 400;
+            const   long long   yoe = y - era * 400;
+            const   long long   doy =
+                (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+            const   long long   doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            const   long long   days = era * 146097 + doe - 719468;
+
+            return (((days * 24 + hour) * 60 + minute) * 60 + second);
+        }
+
+        inline bool operator == (const XMLTimeStamp &rhs) const throw ()  {
+
+            return (packed () == rhs.packed ());
+        }
+        inline bool operator < (const XMLTimeStamp &rhs) const throw ()  {
+
+            return (packed () < rhs.packed ());
+        }
+};
+
+// ----------------------------------------------------------------------------
+
+// Implementation details
+//
+namespace xml_conv_
+{
+
+inline bool is_space (char c) throw ()  {
+
+    return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+}
+
+inline bool is_digit (char c) throw ()  {
+
+    return (static_cast<unsigned char>(c - '0') < 10);
+}
+
+// Trims XML white space off both ends. It returns false, if nothing is left.
+//
+inline bool trim (const char *&begin, const char *&end) throw ()  {
+
+    for (end = begin; *end; ++end)  ;
+    while (begin < end && is_space (*begin))
+        ++begin;
+    while (end > begin && is_space (*(end - 1)))
+        --end;
+
+    return (begin < end);
+}
+
+// Reads the unsigned decimal digits in [begin, end) into value.
+//
+inline XMLConvStatus
+read_digits (const char *begin, const char *end,
+             unsigned long long &value) throw ()  {
+
+    static  const   unsigned long long  max_value =
+        std::numeric_limits<unsigned long long>::max ();
+
+    if (begin == end)
+        return (xcs_invalid);
+
+    value = 0;
+    for (; begin < end; ++begin)  {
+        if (! is_digit (*begin))
+            return (xcs_invalid);
+
+        const   unsigned    digit = *begin - '0';
+
+        if (value > (max_value - digit) / 10)  {
+            while (++begin < end)  // Tell garbage from overflow
+                if (! is_digit (*begin))
+                    return (xcs_invalid);
+            return (xcs_out_of_range);
+        }
+        value = value * 10 + digit;
+    }
+
+    return (xcs_ok);
+}
+
+inline locale_t c_locale () throw ()  {
+
+    static  const   locale_t    loc =
+        ::newlocale (LC_ALL_MASK, "C", static_cast<locale_t>(0));
+
+    return (loc);
+}
+
+// The slow path. The value is copied, since strtod_l() needs it null
+// terminated and [begin, end) may not be. strtod_l() sets its result even
+// if the value is invalid or out of range, so value is only set on xcs_ok.
+//
+inline XMLConvStatus
+read_double_slow (const char *begin, const char *end, double &value) throw() {
+
+    char                buffer [128];
+    const   std::size_t len = end - begin;
+
+    if (len >= sizeof (buffer))
+        return (xcs_invalid);
+    for (std::size_t i = 0; i < len; ++i)
+        buffer [i] = begin [i];
+    buffer [len] = 0;
+
+    char        *stop = NULL;
+    const   int saved_errno = errno;
+
+    errno = 0;
+
+    const   double  result = ::strtod_l (buffer, &stop, c_locale ());
+    const   bool    out_of_range = errno == ERANGE;
+
+    errno = saved_errno;
+    if (stop != buffer + len || stop == buffer)
+        return (xcs_invalid);
+    if (out_of_range &&
+        (result == 0 || result > DBL_MAX || result < -DBL_MAX))
+        return (xcs_out_of_range);
+    value = result;
+    return (xcs_ok);
+}
+
+// Exact powers of ten that a double can hold
+//
+static  const   double  pow10_tab [] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline XMLConvStatus
+read_double (const char *begin, const char *end, double &value) throw ()  {
+
+    const   char    *const  start = begin;
+    bool                    negative = false;
+
+    if (*begin == '-' || *begin == '+')
+        negative = *begin++ == '-';
+
+    unsigned long long  mantissa = 0;
+    int                 digits = 0;  // Significant digits in mantissa
+    int                 exp10 = 0;
+    bool                any_digit = false;
+    bool                exact = true;
+
+    for (; begin < end && is_digit (*begin); ++begin, any_digit = true)  {
+        if (digits < 19)  {
+            mantissa = mantissa * 10 + (*begin - '0');
+            digits += mantissa != 0;
+        }
+        else  {
+            exp10 += 1;
+            exact = exact && *begin == '0';
+        }
+    }
+    if (begin < end && *begin == '.')  {
+        for (++begin; begin < end && is_digit (*begin);
+             ++begin, any_digit = true)
+            if (digits < 19)  {
+                mantissa = mantissa * 10 + (*begin - '0');
+                digits += mantissa != 0;
+                exp10 -= 1;
+            }
+            else
+                exact = exact && *begin == '0';
+    }
+    if (! any_digit)  // Maybe INF or NaN
+        return (read_double_slow (start, end, value));
+
+    if (begin < end && (*begin == 'e' || *begin == 'E'))  {
+        bool    exp_negative = false;
+
+        if (++begin < end && (*begin == '-' || *begin == '+'))
+            exp_negative = *begin++ == '-';
+
+        unsigned long long  exp_value = 0;
+
+        if (read_digits (begin, end, exp_value) != xcs_ok)
+            return (read_double_slow (start, end, value));
+        if (exp_value > 400)
+            return (read_double_slow (start, end, value));
+        exp10 += exp_negative ? -int (exp_value) : int (exp_value);
+        begin = end;
+    }
+    if (begin != end)
+        return (xcs_invalid);
+
+   // The mantissa and the power of ten are both exact, so one
+   // multiplication or division rounds correctly.
+   //
+    if (exact && mantissa <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22)  {
+        value = double (mantissa);
+        if (exp10 < 0)
+            value /= pow10_tab [-exp10];
+        else
+            value *= pow10_tab [exp10];
+        if (negative)
+            value = -value;
+        return (xcs_ok);
+    }
+    if (mantissa == 0)  {
+        value = negative ? -0.0 : 0.0;
+        return (xcs_ok);
+    }
+
+    return (read_double_slow (start, end, value));
+}
+
+inline unsigned read_2 (const char *str) throw ()  {
+
+    return ((str [0] - '0') * 10 + (str [1] - '0'));
+}
+
+} // namespace xml_conv_
+
+// ----------------------------------------------------------------------------
+
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value &&
+                                   ! std::is_same<T, bool>::value,
+                               XMLConvStatus>::type
+XMLconvert (const char *str, T &value) throw ()  {
+
+    if (str == NULL)
+        return (xcs_missing);
+
+    const   char    *end = NULL;
+
+    if (! xml_conv_::trim (str, end))
+        return (xcs_invalid);
+
+    bool    negative = false;
+
+    if (*str == '-' || *str == '+')
+        negative = *str++ == '-';
+
+    unsigned long long      abs_value = 0;
+    const   XMLConvStatus   status =
+        xml_conv_::read_digits (str, end, abs_value);
+
+    if (status != xcs_ok)
+        return (status);
+
+    if (negative)  {
+        if (! std::is_signed<T>::value && abs_value != 0)
+            return (xcs_out_of_range);
+        if (std::is_signed<T>::value && abs_value >
+            static_cast<unsigned long long>(std::numeric_limits<T>::max ()) +
+                1)
+            return (xcs_out_of_range);
+        value = abs_value == 0
+            ? T (0)
+            : static_cast<T>(-static_cast<long long>(abs_value - 1) - 1);
+    }
+    else  {
+        if (abs_value >
+            static_cast<unsigned long long>(std::numeric_limits<T>::max ()))
+            return (xcs_out_of_range);
+        value = static_cast<T>(abs_value);
+    }
+
+    return (xcs_ok);
+}
+
+// ----------------------------------------------------------------------------
+
+inline XMLConvStatus XMLconvert (const char *str, double &value) throw ()  {
+
+    if (str == NULL)
+        return (xcs_missing);
+
+    const   char    *end = NULL;
+
+    if (! xml_conv_::trim (str, end))
+        return (xcs_invalid);
+    return (xml_conv_::read_double (str, end, value));
+}
+
+// ----------------------------------------------------------------------------
+
+inline XMLConvStatus XMLconvert (const char *str, float &value) throw ()  {
+
+    double                  dvalue = 0;
+    const   XMLConvStatus   status = XMLconvert (str, dvalue);
+
+    if (status != xcs_ok)
+        return (status);
+    if (dvalue > FLT_MAX || dvalue < -FLT_MAX)
+        if (dvalue <= DBL_MAX && dvalue >= -DBL_MAX)  // Not infinity
+            return (xcs_out_of_range);
+    value = static_cast<float>(dvalue);
+    return (xcs_ok);
+}
+
+// ----------------------------------------------------------------------------
+
+inline XMLConvStatus XMLconvert (const char *str, bool &value) throw ()  {
+
+    if (str == NULL)
+        return (xcs_missing);
+
+    const   char    *end = NULL;
+
+    if (! xml_conv_::trim (str, end))
+        return (xcs_invalid);
+
+    const   std::size_t len = end - str;
+
+    if (len == 1 && (*str == '1' || *str == '0'))
+        value = *str == '1';
+    else if (len == 4 && ! ::strncmp (str, "true", 4))
+        value = true;
+    else if (len == 5 && ! ::strncmp (str, "false", 5))
+        value = false;
+    else
+        return (xcs_invalid);
+
+    return (xcs_ok);
+}
+
+// ----------------------------------------------------------------------------
+
+inline XMLConvStatus
+XMLconvert (const char *str, XMLTimeStamp &value) throw ()  {
+
+    static  const   unsigned char   month_days [] =
+        { 0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    if (str == NULL)
+        return (xcs_missing);
+
+    const   char    *end = NULL;
+
+    if (! xml_conv_::trim (str, end))
+        return (xcs_invalid);
+
+    const   std::size_t len = end - str;
+
+    if (len != 14 && len != 8)
+        return (xcs_invalid);
+    for (std::size_t i = 0; i < len; ++i)
+        if (! xml_conv_::is_digit (str [i]))
+            return (xcs_invalid);
+
+    XMLTimeStamp    ts;
+
+    ts.year = xml_conv_::read_2 (str) * 100 + xml_conv_::read_2 (str + 2);
+    ts.month = xml_conv_::read_2 (str + 4);
+    ts.day = xml_conv_::read_2 (str + 6);
+    if (len == 14)  {
+        ts.hour = xml_conv_::read_2 (str + 8);
+        ts.minute = xml_conv_::read_2 (str + 10);
+        ts.second = xml_conv_::read_2 (str + 12);
+    }
+
+    const   bool    leap_year =
+        (ts.year % 4 == 0 && ts.year % 100 != 0) || ts.year % 400 == 0;
+
+    if (ts.month < 1 || ts.month > 12 ||
+        ts.day < 1 || ts.day > month_days [ts.month] ||
+        (ts.month == 2 && ts.day == 29 && ! leap_year) ||
+        ts.hour > 23 || ts.minute > 59 || ts.second > 60)
+        return (xcs_out_of_range);
+
+    value = ts;
+    return (xcs_ok);
+}
+
+// ----------------------------------------------------------------------------
+
+// The reverse of XMLconvert(): the text of value, in the form XMLconvert()
+// reads back. The text is written into buffer, unless value already has
+// one.
+//
+// NOTE: buffer must have room for XMLFORMAT_BUFFER_SIZE chars.
+//
+enum  { XMLFORMAT_BUFFER_SIZE = 32 };
+
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value &&
+                                   ! std::is_same<T, bool>::value,
+                               const char *>::type
+XMLformat (T value, char *buffer) throw ()  {
+
+    if (std::is_signed<T>::value)
+        ::snprintf (buffer, XMLFORMAT_BUFFER_SIZE, "%lld",
+                    static_cast<long long>(value));
+    else
+        ::snprintf (buffer, XMLFORMAT_BUFFER_SIZE, "%llu",
+                    static_cast<unsigned long long>(value));
+    return (buffer);
+}
+
+// ----------------------------------------------------------------------------
+
+// The shortest of 15 or 17 significant digits that reads back the same
+// value
+//
+inline const char *XMLformat (double value, char *buffer) throw ()  {
+
+    const   locale_t    old_locale = ::uselocale (xml_conv_::c_locale ());
+    double              back = 0;
+
+    ::snprintf (buffer, XMLFORMAT_BUFFER_SIZE, "%.15g", value);
+    if (XMLconvert (buffer, back) != xcs_ok || back != value)
+        ::snprintf (buffer, XMLFORMAT_BUFFER_SIZE, "%.17g", value);
+    ::uselocale (old_locale);
+    return (buffer);
+}
+
+inline const char *XMLformat (float value, char *buffer) throw ()  {
+
+    return (XMLformat (static_cast<double>(value), buffer));
+}
+
+// ----------------------------------------------------------------------------
+
+inline const char *XMLformat (bool value, char *) throw ()  {
+
+    return (value ? "true" : "false");
+}
+
+// ----------------------------------------------------------------------------
+
+inline const char *
+XMLformat (const XMLTimeStamp &value, char *buffer) throw ()  {
+
+    ::snprintf (buffer, XMLFORMAT_BUFFER_SIZE, "%014llu", value.packed ());
+    return (buffer);
+}
+
+// ----------------------------------------------------------------------------
+
+inline const char *XMLformat (const std::string &value, char *) throw ()  {
+
+    return (value.c_str ());
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLTypedValue_h
+#define _INCLUDED_XMLTypedValue_h 1
+#endif    // _INCLUDED_XMLTypedValue_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
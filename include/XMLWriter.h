@@ -9,6 +9,7 @@
 // ----------------------------------------------------------------------------
 
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -24,7 +25,12 @@ class   XMLWriter  {
 
         typedef unsigned int    size_type;
 
-        inline XMLWriter () throw ()  { needs_indent = true; }
+        inline XMLWriter ()  {
+
+            needs_indent = true;
+            stack_.reserve (32);
+            names_.reserve (1024);
+        }
 
         void write_open_tag (const char *name);
         void write_close_tag ();
@@ -35,9 +41,16 @@ class   XMLWriter  {
         void write_cdata (const char *cdata);
         void write_comment (const char *const comment);
 
+       // The whole "<!--" ... "-->" that write_comment() writes
+       //
+        static void encode_comment (const char *const comment,
+                                    std::string &encoded_comment);
         static bool decode_comment (const std::string &encoded_comment,
                                     std::string &decoded_comment);
 
+       // Escapes input as an attribute value. Valid UTF-8 is kept as is.
+       // See XMLencode_literal() in XMLEscape.h.
+       //
         static void encode_literal (const char *const input,
                                     std::string &output) throw ();
 
@@ -47,16 +60,26 @@ class   XMLWriter  {
 
         virtual void write (const char *str) = 0;
 
+       // An element doesn't own a copy of its name. The name is appended,
+       // with its terminating NUL, to the writer's names_ and the element
+       // keeps its offset. Closing the element truncates names_ back to
+       // that offset. Once stack_ and names_ have grown to the deepest
+       // nesting, opening and closing elements doesn't allocate.
+       //
         class   Element  {
 
             public:
 
-                Element (XMLWriter *writer, const char *name) throw ()
+                Element (XMLWriter *writer, const char *name)
                     : writer_ (writer),
-                      name_ (name),
-                      state_ (es_initial)  {   }
+                      name_offset_ (writer->names_.size ()),
+                      state_ (es_initial)  {
+
+                    writer->names_.append (name, ::strlen (name) + 1);
+                }
                 Element () throw ()
-                    : writer_ (NULL), name_ (""), state_ (es_initial)  {   }
+                    : writer_ (NULL), name_offset_ (0), state_ (es_initial)  {
+                }
 
 
                 void write_open_tag ();
@@ -68,6 +91,11 @@ class   XMLWriter  {
 
                 void notify_child_inserted ();
 
+                inline std::string::size_type name_offset () const throw ()  {
+
+                    return (name_offset_);
+                }
+
                 inline void write (const char *s)  { writer_->write (s); }
 
                 inline void indent ()  { writer_->indent (); }
@@ -86,28 +114,14 @@ class   XMLWriter  {
 
                      return (writer_->get_current_element ());
                 }
+                inline const char *get_name () const throw ()  {
 
-                std::string     name_;
-                XMLWriter   *writer_;
-                State           state_;
-
-            public:
-
-                Element (const Element &that) throw ()
-                    : writer_ (NULL), name_ (""), state_ (es_initial)  {
-                    (*this) = that;
-                }
-                Element *operator = (const Element &rhs) throw ()  {
-
-                    if (this != &rhs)  {
-                        name_ = rhs.name_;
-                        writer_ = rhs.writer_;
-                        state_ = rhs.state_;
-                    }
-
-                    return (this);
+                    return (writer_->names_.c_str () + name_offset_);
                 }
 
+                XMLWriter               *writer_;
+                std::string::size_type  name_offset_;
+                State                   state_;
         };
 
         void indent ();
@@ -116,6 +130,8 @@ class   XMLWriter  {
         inline size_type depth () const throw ()  { return (stack_.size ()); }
 
         std::vector<Element>    stack_;
+        std::string             names_;
+        std::string             literal_;
 
         inline Element *get_current_element () throw ()  {
 
@@ -0,0 +1,65 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_XMLXercesSupport_h
+#define _INCLUDED_XMLXercesSupport_h 0
+
+// ----------------------------------------------------------------------------
+
+#include <string>
+
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// Keeps Xerces initialized for as long as it lives. Xerces counts the calls
+// to Initialize() and only really terminates on the last call to
+// Terminate().
+// A class that owns Xerces objects makes it its first member, so Xerces is
+// initialized before they are constructed, and terminated after they are
+// destroyed.
+//
+class   XMLXercesInitializer  {
+
+    public:
+
+        XMLXercesInitializer ();
+        ~XMLXercesInitializer () throw ();
+
+    private:
+
+       // These are not implemented and therefore prohibited
+       //
+        XMLXercesInitializer (const XMLXercesInitializer &);
+        XMLXercesInitializer &operator = (const XMLXercesInitializer &);
+};
+
+// ----------------------------------------------------------------------------
+
+// The text of a warning, error or fatal error that the parser reported
+// through the SAX ErrorHandler interface. severity is its first word, e.g.
+// "FATAL ERROR".
+//
+std::string
+XMLparse_error_text (const char *severity,
+                     const XERCES_CPP_NAMESPACE::SAXParseException &e);
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_XMLXercesSupport_h
+#define _INCLUDED_XMLXercesSupport_h 1
+#endif    // _INCLUDED_XMLXercesSupport_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -10,21 +10,51 @@ PROJECT_INCLUDE_DIR = ../../include
 
 # -----------------------------------------------------------------------------
 
-SRCS = XMLParser.cc \
+SRCS = XMLArenaMemoryManager.cc \
+       XMLAsyncIngest.cc \
+       XMLBinder.cc \
+       XMLBufferedWriter.cc \
+       XMLCursor.cc \
+       XMLInputSources.cc \
+       XMLIovecSink.cc \
+       XMLParallelVisitor.cc \
+       XMLParser.cc \
        XMLString.cc \
        XMLWriter.cc \
-       xml_tester.cc
-
-HEADERS = $(LOCAL_INCLUDE_DIR)/XMLNVPair.h \
+       XMLXercesSupport.cc \
+       xml_tester.cc \
+       latency_bench.cc \
+       xml_bench.cc \
+       mem_bench.cc \
+       dtd_codegen.cc
+
+HEADERS = $(LOCAL_INCLUDE_DIR)/XMLArenaMemoryManager.h \
+          $(LOCAL_INCLUDE_DIR)/XMLAsyncIngest.h \
+          $(LOCAL_INCLUDE_DIR)/XMLBinder.h \
+          $(LOCAL_INCLUDE_DIR)/XMLBufferedWriter.h \
+          $(LOCAL_INCLUDE_DIR)/XMLBufferedWriter.tcc \
+          $(LOCAL_INCLUDE_DIR)/XMLCursor.h \
+          $(LOCAL_INCLUDE_DIR)/XMLEscape.h \
+          $(LOCAL_INCLUDE_DIR)/XMLInputSources.h \
+          $(LOCAL_INCLUDE_DIR)/XMLIovecSink.h \
+          $(LOCAL_INCLUDE_DIR)/XMLNVPair.h \
+          $(LOCAL_INCLUDE_DIR)/XMLParallelVisitor.h \
           $(LOCAL_INCLUDE_DIR)/XMLParser.h \
+          $(LOCAL_INCLUDE_DIR)/XMLParseStats.h \
           $(LOCAL_INCLUDE_DIR)/XMLString.h \
           $(LOCAL_INCLUDE_DIR)/XMLTreeNodes.h \
-          $(LOCAL_INCLUDE_DIR)/XMLWriter.h
+          $(LOCAL_INCLUDE_DIR)/XMLTypedValue.h \
+          $(LOCAL_INCLUDE_DIR)/XMLWriter.h \
+          $(LOCAL_INCLUDE_DIR)/XMLXercesSupport.h
 
 LIB_NAME = XMLParser
 TARGET_LIB = $(LOCAL_LIB_DIR)/lib$(LIB_NAME).a
 
-TARGETS = $(TARGET_LIB) $(LOCAL_BIN_DIR)/xml_tester
+TARGETS = $(TARGET_LIB) $(LOCAL_BIN_DIR)/xml_tester \
+          $(LOCAL_BIN_DIR)/latency_bench \
+          $(LOCAL_BIN_DIR)/xml_bench \
+          $(LOCAL_BIN_DIR)/mem_bench \
+          $(LOCAL_BIN_DIR)/dtd_codegen
 
 # -----------------------------------------------------------------------------
 
@@ -35,13 +65,49 @@ INCLUDES += -I. -I$(LOCAL_INCLUDE_DIR) -I$(PROJECT_INCLUDE_DIR)
 DEFINES = -D_REENTRANT -DDMS_INCLUDE_SOURCE \
           -DP_THREADS -D_POSIX_PTHREAD_SEMANTICS -DDMS_$(BUILD_DEFINE)__
 
+# Compressed input support (see XMLInputSources.h). Turn it on with
+#   make -f Makefile.xxx XMLPARSER_ZLIB=1 XMLPARSER_ZSTD=1
+#
+ifdef XMLPARSER_ZLIB
+DEFINES += -DXMLPARSER_HAVE_ZLIB
+PLATFORM_LIBS += -lz
+endif
+ifdef XMLPARSER_ZSTD
+DEFINES += -DXMLPARSER_HAVE_ZSTD
+PLATFORM_LIBS += -lzstd
+endif
+
+# Parse statistics (see XMLParseStats.h). Turn them on with
+#   make -f Makefile.xxx XMLPARSER_STATS=1
+#
+ifdef XMLPARSER_STATS
+DEFINES += -DXMLPARSER_STATS
+endif
+
+# io_uring reads in XMLAsyncIngest. Turn it on with
+#   make -f Makefile.xxx XMLPARSER_URING=1
+#
+ifdef XMLPARSER_URING
+DEFINES += -DXMLPARSER_HAVE_LIBURING
+PLATFORM_LIBS += -luring
+endif
+
 # -----------------------------------------------------------------------------
 
 # object file
 #
-LIB_OBJS = $(LOCAL_OBJ_DIR)/XMLParser.o \
+LIB_OBJS = $(LOCAL_OBJ_DIR)/XMLArenaMemoryManager.o \
+           $(LOCAL_OBJ_DIR)/XMLAsyncIngest.o \
+           $(LOCAL_OBJ_DIR)/XMLBinder.o \
+           $(LOCAL_OBJ_DIR)/XMLBufferedWriter.o \
+           $(LOCAL_OBJ_DIR)/XMLCursor.o \
+           $(LOCAL_OBJ_DIR)/XMLInputSources.o \
+           $(LOCAL_OBJ_DIR)/XMLIovecSink.o \
+           $(LOCAL_OBJ_DIR)/XMLParallelVisitor.o \
+           $(LOCAL_OBJ_DIR)/XMLParser.o \
            $(LOCAL_OBJ_DIR)/XMLString.o \
-           $(LOCAL_OBJ_DIR)/XMLWriter.o
+           $(LOCAL_OBJ_DIR)/XMLWriter.o \
+           $(LOCAL_OBJ_DIR)/XMLXercesSupport.o
 
 # -----------------------------------------------------------------------------
 
@@ -70,16 +136,58 @@ $(TARGET_LIB): $(LIB_OBJS)
 	ar -clrs $(TARGET_LIB) $(LIB_OBJS)
 
 XML_TESTER_OBJ = $(LOCAL_OBJ_DIR)/xml_tester.o
-$(LOCAL_BIN_DIR)/xml_tester: $(XML_TESTER_OBJ) $(HEADERS)
+$(LOCAL_OBJ_DIR)/xml_tester.o: data_query_gen.h
+$(LOCAL_BIN_DIR)/xml_tester: $(XML_TESTER_OBJ) $(TARGET_LIB) $(HEADERS)
 	$(CXX) -o $@ $(XML_TESTER_OBJ) $(LIBS)
 
+LATENCY_BENCH_OBJ = $(LOCAL_OBJ_DIR)/latency_bench.o
+$(LOCAL_BIN_DIR)/latency_bench: $(LATENCY_BENCH_OBJ) $(TARGET_LIB) $(HEADERS)
+	$(CXX) -o $@ $(LATENCY_BENCH_OBJ) $(LIBS)
+
+XML_BENCH_OBJ = $(LOCAL_OBJ_DIR)/xml_bench.o
+$(LOCAL_OBJ_DIR)/xml_bench.o: xml_doc_generator.h
+$(LOCAL_BIN_DIR)/xml_bench: $(XML_BENCH_OBJ) $(TARGET_LIB) $(HEADERS)
+	$(CXX) -o $@ $(XML_BENCH_OBJ) $(LIBS)
+
+MEM_BENCH_OBJ = $(LOCAL_OBJ_DIR)/mem_bench.o
+$(LOCAL_OBJ_DIR)/mem_bench.o: xml_doc_generator.h
+$(LOCAL_BIN_DIR)/mem_bench: $(MEM_BENCH_OBJ) $(TARGET_LIB) $(HEADERS)
+	$(CXX) -o $@ $(MEM_BENCH_OBJ) $(LIBS)
+
+# The code generator doesn't use the library
+#
+DTD_CODEGEN_OBJ = $(LOCAL_OBJ_DIR)/dtd_codegen.o
+$(LOCAL_BIN_DIR)/dtd_codegen: $(DTD_CODEGEN_OBJ)
+	$(CXX) -o $@ $(DTD_CODEGEN_OBJ)
+
+# Generates the struct bindings of data_query.dtd. xml_tester binds
+# data_query.xml through them.
+#
+data_query_gen.h: data_query.dtd $(LOCAL_BIN_DIR)/dtd_codegen
+	$(LOCAL_BIN_DIR)/dtd_codegen -n=data_query \
+	    -t=HM_REQUEST@CLIENT_PROCESS_ID=long \
+	    -t=SYMBOL@START=timestamp -t=SYMBOL@END=timestamp \
+	    -t=SYMBOL@REFERENCE=unsigned \
+	    -o=$@ data_query.dtd
+
+# Runs the benchmarks and leaves the CSV results in BENCH_RESULTS and
+# MEM_BENCH_RESULTS
+#
+BENCH_RESULTS = xml_bench_$(BUILD_PLATFORM).csv
+MEM_BENCH_RESULTS = mem_bench_$(BUILD_PLATFORM).csv
+bench: PRE_BUILD $(LOCAL_BIN_DIR)/xml_bench $(LOCAL_BIN_DIR)/mem_bench
+	$(LOCAL_BIN_DIR)/xml_bench > $(BENCH_RESULTS)
+	$(LOCAL_BIN_DIR)/mem_bench > $(MEM_BENCH_RESULTS)
+
 # -----------------------------------------------------------------------------
 
 depend:
 	makedepend $(CXXFLAGS) -Y $(SRC)
 
 clobber:
-	rm -f $(LIB_OBJS) $(TARGETS) $(XML_TESTER_OBJ)
+	rm -f $(LIB_OBJS) $(TARGETS) $(XML_TESTER_OBJ) $(LATENCY_BENCH_OBJ) \
+          $(XML_BENCH_OBJ) $(MEM_BENCH_OBJ) $(DTD_CODEGEN_OBJ) \
+          data_query_gen.h
 
 install_lib:
 	cp -pf $(TARGET_LIB) $(PROJECT_LIB_DIR)/.
@@ -0,0 +1,136 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <new>
+
+#include <xercesc/util/PlatformUtils.hpp>
+
+#include <XMLArenaMemoryManager.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+XMLArenaMemoryManager::XMLArenaMemoryManager (size_type chunk_size) throw ()
+    : chunk_size_ (chunk_size),
+      cur_ (NULL),
+      end_ (NULL),
+      arena_size_ (0),
+      bytes_allocated_ (0),
+      heap_allocations_ (0)  {
+
+    for (size_type i = 0; i < NUM_CLASSES; ++i)
+        free_lists_ [i] = NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+XMLArenaMemoryManager::~XMLArenaMemoryManager () throw ()  {
+
+    for (std::vector<char *>::const_iterator itr = chunks_.begin ();
+         itr != chunks_.end (); ++itr)
+        ::operator delete (*itr);
+}
+
+// ----------------------------------------------------------------------------
+
+// Returns block_size bytes from the current chunk. If the current chunk is
+// exhausted, its tail is given up and a new chunk is started.
+//
+char *XMLArenaMemoryManager::carve_ (size_type block_size)  {
+
+    if (cur_ == NULL || block_size > size_type (end_ - cur_))  {
+        const   size_type   new_size =
+            block_size > chunk_size_ ? block_size : chunk_size_;
+
+        chunks_.push_back (static_cast<char *>(::operator new (new_size)));
+        heap_allocations_ += 1;
+        arena_size_ += new_size;
+        cur_ = chunks_.back ();
+        end_ = cur_ + new_size;
+    }
+
+    char    *const  block = cur_;
+
+    cur_ += block_size;
+    return (block);
+}
+
+// ----------------------------------------------------------------------------
+
+void *XMLArenaMemoryManager::allocate (XMLSize_t size)  {
+
+    const   size_type   sc = size_class_ (size ? size : 1);
+    BlockHeader         *header = NULL;
+
+    if (sc < NUM_CLASSES)  {
+        const   size_type   payload = size_type (1) << (sc + MIN_CLASS_SHIFT);
+
+        if (free_lists_ [sc] != NULL)  {
+            FreeBlock   *const  fb = free_lists_ [sc];
+
+            free_lists_ [sc] = fb->next;
+            header = reinterpret_cast<BlockHeader *>(fb) - 1;
+        }
+        else
+            header = reinterpret_cast<BlockHeader *>(
+                carve_ (sizeof (BlockHeader) + payload));
+
+        header->size_class = sc;
+        bytes_allocated_ += payload;
+    }
+    else  {
+        header = static_cast<BlockHeader *>(
+            ::operator new (sizeof (BlockHeader) + size));
+        header->size_class = LARGE_BLOCK;
+        heap_allocations_ += 1;
+        bytes_allocated_ += size;
+    }
+
+    return (header + 1);
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLArenaMemoryManager::deallocate (void *p)  {
+
+    if (p == NULL)
+        return;
+
+    BlockHeader *const  header = static_cast<BlockHeader *>(p) - 1;
+
+    if (header->size_class == LARGE_BLOCK)
+        ::operator delete (header);
+    else  {
+        FreeBlock   *const  fb = static_cast<FreeBlock *>(p);
+
+        fb->next = free_lists_ [header->size_class];
+        free_lists_ [header->size_class] = fb;
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Exceptions may outlive the parser that threw them, so they get their
+// memory from the global manager.
+//
+XERCES_CPP_NAMESPACE::MemoryManager *
+XMLArenaMemoryManager::getExceptionMemoryManager ()  {
+
+    return (XERCES_CPP_NAMESPACE::XMLPlatformUtils::fgMemoryManager);
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,619 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef XMLPARSER_HAVE_LIBURING
+#  include <liburing.h>
+#endif // XMLPARSER_HAVE_LIBURING
+
+#include <DMScu_FixedSizeString.h>
+
+#include <XMLAsyncIngest.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+XMLAsyncIngest::XMLAsyncIngest (size_type parser_threads,
+                                size_type chunk_size,
+                                size_type read_ahead,
+                                XERCES_CPP_NAMESPACE::SAXParser::ValSchemes vs)
+    : chunk_size_ (chunk_size > 0 ? chunk_size : 1),
+      vs_ (vs),
+      use_uring_ (false),
+      stop_ (false),
+      in_flight_ (0)  {
+
+    if (read_ahead == 0)
+        read_ahead = 1;
+    if (parser_threads == 0)
+        parser_threads = 1;
+
+    chunks_.reserve (read_ahead);
+    free_chunks_.reserve (read_ahead);
+    for (size_type i = 0; i < read_ahead; ++i)  {
+        chunks_.push_back (std::unique_ptr<Chunk_> (new Chunk_ (chunk_size_)));
+        free_chunks_.push_back (chunks_.back ().get ());
+    }
+
+#ifdef XMLPARSER_HAVE_LIBURING
+   // There can never be more reads in flight than chunks. If io_uring is
+   // not available (old kernel, seccomp, ...), the I/O thread uses pread().
+   //
+    struct  io_uring    *ring = new struct io_uring;
+
+    if (::io_uring_queue_init (unsigned (read_ahead), ring, 0) == 0)  {
+        ring_ = ring;
+        use_uring_ = true;
+    }
+    else  {
+        delete ring;
+        ring_ = NULL;
+    }
+#endif // XMLPARSER_HAVE_LIBURING
+
+    io_thread_ = std::thread (&XMLAsyncIngest::io_loop_, this);
+    parser_threads_.reserve (parser_threads);
+    for (size_type i = 0; i < parser_threads; ++i)
+        parser_threads_.push_back (
+            std::thread (&XMLAsyncIngest::parser_loop_, this));
+}
+
+// ----------------------------------------------------------------------------
+
+XMLAsyncIngest::~XMLAsyncIngest ()  {
+
+    {
+        const   std::lock_guard<std::mutex> guard (mutex_);
+
+        stop_ = true;
+    }
+    work_cond_.notify_all ();
+    for (std::vector<std::thread>::iterator itr = parser_threads_.begin ();
+         itr != parser_threads_.end (); ++itr)
+        itr->join ();
+
+   // By now, all the jobs are finished
+   //
+    io_cond_.notify_all ();
+    io_thread_.join ();
+
+#ifdef XMLPARSER_HAVE_LIBURING
+    if (ring_ != NULL)  {
+        ::io_uring_queue_exit (static_cast<struct io_uring *>(ring_));
+        delete static_cast<struct io_uring *>(ring_);
+    }
+#endif // XMLPARSER_HAVE_LIBURING
+}
+
+// ----------------------------------------------------------------------------
+
+// Opening a named pipe blocks until there is a writer, so everything is
+// opened non-blocking. Regular files are then made blocking again.
+//
+void XMLAsyncIngest::
+submit (const std::string &file, const Completion &completion)  {
+
+    const   int     fd = ::open (file.c_str (), O_RDONLY | O_NONBLOCK);
+    const   int     open_errno = fd < 0 ? errno : 0;
+    size_type       file_size = 0;
+    bool            streamed = false;
+
+   // Only regular files are read ahead. A pipe, for example, has no size
+   // and would otherwise be parsed as an empty document.
+   //
+    if (fd >= 0)  {
+        struct  stat    file_stat;
+
+        if (::fstat (fd, &file_stat) == 0 && S_ISREG (file_stat.st_mode))  {
+            ::fcntl (fd, F_SETFL, ::fcntl (fd, F_GETFL) & ~O_NONBLOCK);
+            file_size = file_stat.st_size;
+#ifdef POSIX_FADV_SEQUENTIAL
+            ::posix_fadvise (fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif // POSIX_FADV_SEQUENTIAL
+        }
+        else
+            streamed = true;
+    }
+
+    {
+        const   std::lock_guard<std::mutex> guard (mutex_);
+
+        jobs_.push_back (Job_ ());
+
+        Job_    &job = jobs_.back ();
+
+        job.file = file;
+        job.completion = completion;
+        job.fd = fd;
+        job.open_errno = open_errno;
+        job.file_size = file_size;
+        job.num_chunks = (file_size + chunk_size_ - 1) / chunk_size_;
+        job.next_issue = 0;
+        job.next_consume = 0;
+        job.consume_pos = 0;
+        job.outstanding = 0;
+        job.streamed = streamed;
+        job.abandoned = false;
+        work_queue_.push_back (&job);
+    }
+    io_cond_.notify_one ();
+    work_cond_.notify_one ();
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+std::future<XMLAsyncIngest::DocumentPtr>
+XMLAsyncIngest::submit (const std::string &file)  {
+
+    const   std::shared_ptr<std::promise<DocumentPtr> > promise =
+        std::make_shared<std::promise<DocumentPtr> > ();
+
+    submit (file,
+            [promise] (const std::string &, DocumentPtr doc,
+                       std::exception_ptr error)  {
+                if (error)
+                    promise->set_exception (error);
+                else
+                    promise->set_value (std::move (doc));
+            });
+
+    return (promise->get_future ());
+}
+
+// ----------------------------------------------------------------------------
+
+// Reads are issued for the jobs strictly in submission order. Since the
+// parser threads take the jobs in the same order, a job that is being
+// parsed never waits for chunks held by a job that is not.
+//
+XMLAsyncIngest::Job_ *XMLAsyncIngest::next_to_issue_ () throw ()  {
+
+    for (JobList::iterator itr = jobs_.begin (); itr != jobs_.end (); ++itr)
+        if (itr->next_issue < itr->num_chunks)
+            return (&(*itr));
+    return (NULL);
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLAsyncIngest::complete_chunk_ (Chunk_ *chunk)  {
+
+    Job_    &job = *(chunk->job);
+
+    job.outstanding -= 1;
+    if (job.abandoned)
+        free_chunks_.push_back (chunk);
+    else
+        job.ready [chunk->index] = chunk;
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLAsyncIngest::read_chunk_ (Chunk_ &chunk) throw ()  {
+
+    while (chunk.done < chunk.length)  {
+        const   ssize_t ret =
+            ::pread (chunk.job->fd,
+                     chunk.buffer.get () + chunk.done,
+                     chunk.length - chunk.done,
+                     off_t (chunk.index * chunk_size_ + chunk.done));
+
+        if (ret < 0)  {
+            if (errno == EINTR)
+                continue;
+            chunk.error_no = errno;
+            break;
+        }
+        if (ret == 0)  {  // The file shrank under us
+            chunk.error_no = EIO;
+            break;
+        }
+        chunk.done += ret;
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+#ifdef XMLPARSER_HAVE_LIBURING
+
+// Queues a read of what is left of the chunk. It doesn't submit it.
+//
+static void queue_read (struct io_uring *ring, int fd,
+                        char *buffer, std::size_t size, off_t offset,
+                        void *user_data)  {
+
+    struct  io_uring_sqe    *sqe = ::io_uring_get_sqe (ring);
+
+    if (sqe == NULL)  {  // Submission queue is full
+        ::io_uring_submit (ring);
+        sqe = ::io_uring_get_sqe (ring);
+    }
+    ::io_uring_prep_read (sqe, fd, buffer, unsigned (size), offset);
+    ::io_uring_sqe_set_data (sqe, user_data);
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLAsyncIngest::submit_chunks_ (std::vector<Chunk_ *> &chunks)  {
+
+    struct  io_uring    *ring = static_cast<struct io_uring *>(ring_);
+
+    for (std::vector<Chunk_ *>::iterator itr = chunks.begin ();
+         itr != chunks.end (); ++itr)
+        queue_read (ring, (*itr)->job->fd,
+                    (*itr)->buffer.get (), (*itr)->length,
+                    off_t ((*itr)->index * chunk_size_), *itr);
+    if (! chunks.empty ())
+        ::io_uring_submit (ring);
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Waits for at least one completion and reaps all that are available.
+// Short reads are resubmitted for the rest of the chunk.
+// It returns the errno, if the ring can't be waited on, and 0 otherwise.
+//
+int XMLAsyncIngest::reap_chunks_ (std::vector<Chunk_ *> &chunks)  {
+
+    struct  io_uring        *ring = static_cast<struct io_uring *>(ring_);
+    struct  io_uring_cqe    *cqe = NULL;
+    int                     ret;
+
+    while ((ret = ::io_uring_wait_cqe (ring, &cqe)) == -EINTR)
+        ;
+    if (ret < 0)
+        return (-ret);
+
+    bool    resubmitted = false;
+
+    do  {
+        Chunk_      &chunk = *static_cast<Chunk_ *>(
+                                 ::io_uring_cqe_get_data (cqe));
+        const   int res = cqe->res;
+
+        ::io_uring_cqe_seen (ring, cqe);
+        if (res == -EINTR || res == -EAGAIN || res > 0)  {
+            if (res > 0)
+                chunk.done += res;
+            if (chunk.done < chunk.length)  {
+                queue_read (ring, chunk.job->fd,
+                            chunk.buffer.get () + chunk.done,
+                            chunk.length - chunk.done,
+                            off_t (chunk.index * chunk_size_ + chunk.done),
+                            &chunk);
+                resubmitted = true;
+                continue;
+            }
+        }
+        else  // Error, or the file shrank under us
+            chunk.error_no = res < 0 ? -res : EIO;
+        chunks.push_back (&chunk);
+    } while (::io_uring_peek_cqe (ring, &cqe) == 0);
+
+    if (resubmitted)
+        ::io_uring_submit (ring);
+
+    return (0);
+}
+
+// ----------------------------------------------------------------------------
+
+// The reads in flight in a ring that can't be waited on are delivered to
+// the parser threads as failed, the same way a failed pread() is. The kernel
+// may still complete them, so their buffers are left to it and the chunks
+// get new ones.
+//
+void XMLAsyncIngest::
+fail_chunks_ (std::vector<Chunk_ *> &chunks, int error_no)  {
+
+    for (std::vector<Chunk_ *>::iterator itr = chunks.begin ();
+         itr != chunks.end (); ++itr)  {
+        (*itr)->error_no = error_no;
+        (*itr)->buffer.release ();
+        (*itr)->buffer.reset (new char [chunk_size_]);
+    }
+
+    return;
+}
+
+#endif // XMLPARSER_HAVE_LIBURING
+
+// ----------------------------------------------------------------------------
+
+void XMLAsyncIngest::io_loop_ ()  {
+
+    std::vector<Chunk_ *>           batch;
+    std::vector<Chunk_ *>           done;
+#ifdef XMLPARSER_HAVE_LIBURING
+    std::vector<Chunk_ *>           issued;  // Reads in flight in the ring
+    bool                            use_ring = use_uring_;
+#else
+    const   bool                    use_ring = false;
+#endif // XMLPARSER_HAVE_LIBURING
+    std::unique_lock<std::mutex>    guard (mutex_);
+
+    for (;;)  {
+        batch.clear ();
+
+       // Without io_uring, the chunks are read one at a time, so each one
+       // is handed to the parser threads as soon as it is read.
+       //
+        while (! free_chunks_.empty () && (use_ring || batch.empty ()))  {
+            Job_    *job = next_to_issue_ ();
+
+            if (job == NULL)
+                break;
+
+            Chunk_  *chunk = free_chunks_.back ();
+
+            free_chunks_.pop_back ();
+            chunk->job = job;
+            chunk->index = job->next_issue++;
+            chunk->length = std::min (chunk_size_,
+                                      job->file_size -
+                                          chunk->index * chunk_size_);
+            chunk->done = 0;
+            chunk->error_no = 0;
+            job->outstanding += 1;
+            batch.push_back (chunk);
+        }
+
+        if (batch.empty () && in_flight_ == 0)  {
+            if (stop_ && jobs_.empty ())
+                return;
+            io_cond_.wait (guard);
+            continue;
+        }
+
+        in_flight_ += batch.size ();
+        guard.unlock ();
+
+        done.clear ();
+#ifdef XMLPARSER_HAVE_LIBURING
+        if (use_ring)  {
+            issued.insert (issued.end (), batch.begin (), batch.end ());
+            submit_chunks_ (batch);
+
+            const   int error_no = reap_chunks_ (done);
+
+            if (error_no == 0)  {
+                for (std::vector<Chunk_ *>::iterator itr = done.begin ();
+                     itr != done.end (); ++itr)
+                    issued.erase (
+                        std::find (issued.begin (), issued.end (), *itr));
+            }
+            else  {  // From now on, the chunks are read with pread()
+                fail_chunks_ (issued, error_no);
+                done.swap (issued);
+                use_ring = false;
+            }
+        }
+        else
+#endif // XMLPARSER_HAVE_LIBURING
+        if (! batch.empty ())  {
+            read_chunk_ (*(batch.front ()));
+            done.swap (batch);
+        }
+
+        guard.lock ();
+        in_flight_ -= done.size ();
+        for (std::vector<Chunk_ *>::iterator itr = done.begin ();
+             itr != done.end (); ++itr)
+            complete_chunk_ (*itr);
+        data_cond_.notify_all ();
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLAsyncIngest::parser_loop_ ()  {
+
+    for (;;)  {
+        Job_    *job = NULL;
+
+        {
+            std::unique_lock<std::mutex>    guard (mutex_);
+
+            work_cond_.wait (guard, [this] () -> bool  {
+                return (! work_queue_.empty () || stop_);
+            });
+            if (work_queue_.empty ())
+                return;
+            job = work_queue_.front ();
+            work_queue_.pop_front ();
+        }
+
+        DocumentPtr         doc;
+        std::exception_ptr  error;
+
+        parse_job_ (*job, doc, error);
+
+       // The job is gone after finish_job_()
+       //
+        const   std::string file = job->file;
+        const   Completion  completion = job->completion;
+
+        finish_job_ (*job);
+        completion (file, std::move (doc), error);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLAsyncIngest::
+parse_job_ (Job_ &job, DocumentPtr &doc, std::exception_ptr &error)  {
+
+    try  {
+        if (job.fd < 0)  {
+            DMScu_FixedSizeString<1023> err;
+
+            err.printf ("XMLAsyncIngest::parse_job_(): "
+                        "Cannot open '%s'. errno: %d (%s)",
+                        job.file.c_str (),
+                        job.open_errno, ::strerror (job.open_errno));
+            throw std::runtime_error (err.c_str ());
+        }
+
+        if (job.streamed)
+            wait_for_writer_ (job);
+
+        doc.reset (new XMLDocument);
+
+        XMLParser   parser (doc->root_, doc->attr_vector_, vs_);
+
+        const   XMLReadCallback raw_cb =
+            job.streamed
+                ? XMLmake_fd_reader (job.fd)
+                : XMLReadCallback (
+                      [this, &job] (char *buffer, std::size_t max_size)
+                          -> long  {
+                          return (read_job_ (job, buffer, max_size));
+                      });
+
+        parser.parse_callback (XMLmake_decompress_reader (raw_cb),
+                               job.file.c_str ());
+
+        doc->fatal_error_ = parser.fatal_error ();
+        doc->error_msgs_ = parser.errors ();
+        doc->warning_msgs_ = parser.warnings ();
+    }
+    catch (...)  {
+        doc.reset ();
+        error = std::current_exception ();
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// A non-blocking read of a named pipe that never had a writer returns 0, as
+// if it were at its end. poll() waits for the first writer to write (or to
+// close), after which the fd can block like any other.
+//
+void XMLAsyncIngest::wait_for_writer_ (const Job_ &job)  {
+
+    struct pollfd   pfd = { job.fd, POLLIN, 0 };
+
+    while (::poll (&pfd, 1, -1) < 0)
+        if (errno != EINTR)  {
+            DMScu_FixedSizeString<1023> err;
+
+            err.printf ("XMLAsyncIngest::wait_for_writer_(): "
+                        "poll() failed on '%s'. errno: %d (%s)",
+                        job.file.c_str (), errno, ::strerror (errno));
+            throw std::runtime_error (err.c_str ());
+        }
+    ::fcntl (job.fd, F_SETFL, ::fcntl (job.fd, F_GETFL) & ~O_NONBLOCK);
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+long XMLAsyncIngest::
+read_job_ (Job_ &job, char *buffer, std::size_t max_size)  {
+
+    std::unique_lock<std::mutex>    guard (mutex_);
+
+    if (job.next_consume == job.num_chunks)
+        return (0);
+
+    data_cond_.wait (guard, [&job] () -> bool  {
+        return (! job.ready.empty () &&
+                job.ready.begin ()->first == job.next_consume);
+    });
+
+    Chunk_  &chunk = *(job.ready.begin ()->second);
+
+    guard.unlock ();
+    if (chunk.error_no != 0)  {  // finish_job_() frees the chunk
+        errno = chunk.error_no;
+        return (-1);
+    }
+
+   // Only this parser thread touches a ready chunk of its job
+   //
+    const   std::size_t size =
+        std::min (max_size, chunk.length - job.consume_pos);
+
+    ::memcpy (buffer, chunk.buffer.get () + job.consume_pos, size);
+    job.consume_pos += size;
+    if (job.consume_pos == chunk.length)  {
+        guard.lock ();
+        job.ready.erase (job.ready.begin ());
+        free_chunks_.push_back (&chunk);
+        job.next_consume += 1;
+        job.consume_pos = 0;
+        guard.unlock ();
+        io_cond_.notify_one ();
+    }
+
+    return (size);
+}
+
+// ----------------------------------------------------------------------------
+
+// The parse may have stopped early, on a fatal error. The reads still in
+// flight for the job must land before its chunks can be reused.
+//
+void XMLAsyncIngest::finish_job_ (Job_ &job)  {
+
+    {
+        std::unique_lock<std::mutex>    guard (mutex_);
+
+        job.next_issue = job.num_chunks;
+        job.abandoned = true;
+        data_cond_.wait (guard, [&job] () -> bool  {
+            return (job.outstanding == 0);
+        });
+        for (std::map<size_type, Chunk_ *>::iterator itr = job.ready.begin ();
+             itr != job.ready.end (); ++itr)
+            free_chunks_.push_back (itr->second);
+        job.ready.clear ();
+
+        if (job.fd >= 0)
+            ::close (job.fd);
+
+        for (JobList::iterator itr = jobs_.begin (); itr != jobs_.end (); ++itr)
+            if (&(*itr) == &job)  {
+                jobs_.erase (itr);
+                break;
+            }
+    }
+    io_cond_.notify_one ();
+
+    return;
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
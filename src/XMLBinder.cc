@@ -0,0 +1,280 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <cstring>
+#include <stdexcept>
+
+#include <DMScu_FixedSizeString.h>
+
+#include <XMLBinder.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+XMLBinderBase::XMLBinderBase (SAXParser::ValSchemes vs, bool strict)
+    : mem_manager_ (new XMLArenaMemoryManager),
+      parser_ (new SAXParser (NULL, mem_manager_.get ())),
+      mem_buf_ (mem_manager_.get ()),
+      strict_ (strict),
+      has_problem_ (false),
+      root_seen_ (false),
+      skip_depth_ (0)  {
+
+    try  {
+        parser_->setValidationScheme (vs);
+        parser_->setDoNamespaces (false);
+        parser_->setDocumentHandler (this);
+        parser_->setErrorHandler (this);
+    }
+    catch (const XERCES_CPP_NAMESPACE::SAXException &ex)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLBinderBase::XMLBinderBase(): "
+                    "ERROR during SAX Parser initialization. "
+                    "Message: '%s'\n",
+                    XMLString::to_stdstring (ex.getMessage ()).c_str ());
+
+        throw std::runtime_error (err.c_str ());
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+XMLBinderBase::~XMLBinderBase () throw ()  {   }
+
+// ----------------------------------------------------------------------------
+
+void XMLBinderBase::start_ (void *object, StartChild_ start_root)  {
+
+    has_problem_ = false;
+    root_seen_ = false;
+    skip_depth_ = 0;
+    fatal_error_.clear ();
+    frames_.clear ();
+    frames_.push_back (Frame_ { object, start_root, NULL, 0 });
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLBinderBase::parse_ (const XERCES_CPP_NAMESPACE::InputSource *source,
+                            const char *const file)  {
+
+    try  {
+        if (source != NULL)
+            parser_->parse (*source);
+        else
+            parser_->parse (file);
+    }
+    catch (const XERCES_CPP_NAMESPACE::SAXException &ex)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLBinderBase::parse_(): SAX exception thrown. "
+                    "Message: '%s'\n",
+                    XMLString::to_stdstring (ex.getMessage ()).c_str ());
+
+        has_problem_ = true;
+        throw std::runtime_error (err.c_str ());
+    }
+    catch (const std::exception &ex)  {
+        has_problem_ = true;
+        throw;
+    }
+    catch (...)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLBinderBase::parse_(): An unknown exception was "
+                    "thrown during parsing.\n"
+                    "No further information is available.");
+
+        has_problem_ = true;
+        throw std::runtime_error (err.c_str ());
+    }
+
+    if (! has_problem_ && ! root_seen_)  {
+        has_problem_ = true;
+        fatal_error_ = "BINDING ERROR: The document has no root element";
+    }
+
+    return (! has_problem_);
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLBinderBase::parse_string_ (const char *const xml,
+                                   std::size_t xml_len,
+                                   const char *const sys_id)  {
+
+    mem_buf_.reset (xml, xml_len, sys_id);
+    return (parse_ (&mem_buf_, NULL));
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLBinderBase::parse_file_ (const char *const file)  {
+
+    return (parse_ (NULL, file));
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLBinderBase::parse_callback_ (const XMLReadCallback &read_cb,
+                                     const char *const sys_id)  {
+
+    const   XMLCallbackInputSource  source (read_cb, sys_id,
+                                            mem_manager_.get ());
+
+    return (parse_ (&source, NULL));
+}
+
+// ----------------------------------------------------------------------------
+
+const char *XMLBinderBase::narrow_value_ (const XMLCh *const value)  {
+
+    XMLString::size_type    len = 0;
+
+    if (XMLString::ascii_len (value, len))  {
+        value_.resize (len);
+        XMLString::narrow_ascii (value, &(value_ [0]), len);
+    }
+    else
+        XMLString::to_stdstring (value_, value);
+
+    return (value_.c_str ());
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLBinderBase::fail_ (const char *what,
+                           const XMLCh *const name,
+                           const char *value)  {
+
+    if (has_problem_)
+        return;
+    has_problem_ = true;
+
+    DMScu_FixedSizeString<1023> err;
+
+    err.printf ("BINDING ERROR: %s '%s'%s%s%s",
+                what,
+                XMLString::to_stdstring (name).c_str (),
+                *value ? " ('" : "",
+                value,
+                *value ? "')" : "");
+
+    fatal_error_ = err.c_str ();
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLBinderBase::fail_ (const char *what,
+                           const char *name,
+                           const XMLCh *const element)  {
+
+    if (has_problem_)
+        return;
+    has_problem_ = true;
+
+    DMScu_FixedSizeString<1023> err;
+
+    err.printf ("BINDING ERROR: %s '%s' in '%s'",
+                what, name, XMLString::to_stdstring (element).c_str ());
+
+    fatal_error_ = err.c_str ();
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLBinderBase::
+is_listed_ (const char *value, const char *const *values) throw ()  {
+
+    for (; *values; ++values)
+        if (! ::strcmp (value, *values))
+            return (true);
+
+    return (false);
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLBinderBase::
+startElement (const XMLCh *const name, AttributeList &attributes) throw ()  {
+
+    if (has_problem_)
+        return;
+    if (skip_depth_ > 0)  {  // Inside an element that is not bound
+        skip_depth_ += 1;
+        return;
+    }
+
+    const   Name_   elem_name = { name, hash_name_ (name) };
+    Frame_          &top = frames_.back ();
+
+    if (! top.start_child (*this, top.object, top.seen,
+                           elem_name, attributes))  {
+        if (strict_)
+            fail_ ("unexpected element", name);
+        else
+            skip_depth_ = 1;
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLBinderBase::endElement (const XMLCh *const name) throw ()  {
+
+    if (has_problem_)
+        return;
+    if (skip_depth_ > 0)
+        skip_depth_ -= 1;
+    else  {
+        const   Frame_  &top = frames_.back ();
+
+        if (strict_)
+            top.end_element (*this, top.seen, name);
+        frames_.pop_back ();
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLBinderBase::error (const SAXParseException &e) throw ()  {
+
+    if (has_problem_)
+        return;
+    has_problem_ = true;
+    fatal_error_ = XMLparse_error_text ("ERROR", e);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLBinderBase::fatalError (const SAXParseException &e) throw ()  {
+
+    if (has_problem_)
+        return;
+    has_problem_ = true;
+    fatal_error_ = XMLparse_error_text ("FATAL ERROR", e);
+    return;
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,73 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <cerrno>
+#include <stdexcept>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <DMScu_FixedSizeString.h>
+
+#include <XMLBufferedWriter.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+void XMLFixedSink::overflow_ (std::size_t len) const  {
+
+    DMScu_FixedSizeString<1023> err;
+
+    err.printf ("XMLFixedSink::write(): Writing %lu more bytes would "
+                "overflow the buffer (%lu of %lu bytes used)",
+                static_cast<unsigned long>(len),
+                static_cast<unsigned long>(size_),
+                static_cast<unsigned long>(capacity_));
+    throw std::runtime_error (err.c_str ());
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLFdSink::write (const char *data, std::size_t len)  {
+
+    while (len > 0)  {
+        const   ssize_t ret = ::write (fd_, data, len);
+
+        if (ret < 0)  {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)  {
+                struct pollfd   pfd = { fd_, POLLOUT, 0 };
+
+                if (::poll (&pfd, 1, -1) >= 0 || errno == EINTR)
+                    continue;
+            }
+
+            DMScu_FixedSizeString<1023> err;
+
+            err.printf ("XMLFdSink::write(): write() failed on fd %d. "
+                        "errno: %d (%s)",
+                        fd_, errno, ::strerror (errno));
+            throw std::runtime_error (err.c_str ());
+        }
+
+        data += ret;
+        len -= std::size_t (ret);
+    }
+
+    return;
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
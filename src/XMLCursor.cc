@@ -0,0 +1,426 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <stdexcept>
+#include <string.h>
+
+#include <xercesc/sax/AttributeList.hpp>
+
+#include <DMScu_FixedSizeString.h>
+
+#include <XMLCursor.h>
+#include <XMLString.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+XMLCursor::XMLCursor (SAXParser::ValSchemes vs, bool do_namespace)
+    : mem_manager_ (new XMLArenaMemoryManager),
+      parser_ (new SAXParser (NULL, mem_manager_.get ())),
+      mem_buf_ (mem_manager_.get ()),
+      open_ (false),
+      has_problem_ (false),
+      got_event_ (false),
+      have_event_ (false),
+      pending_end_ (false),
+      skipping_ (false),
+      event_ (ce_end_document),
+      depth_ (0),
+      open_depth_ (0),
+      attr_count_ (0)  {
+
+    try  {
+        parser_->setValidationScheme (vs);
+        parser_->setDoNamespaces (do_namespace);
+        parser_->setDocumentHandler (this);
+        parser_->setErrorHandler (this);
+    }
+    catch (const XERCES_CPP_NAMESPACE::SAXException &ex)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLCursor::XMLCursor(): "
+                    "ERROR during SAX Parser initialization. "
+                    "Message: '%s'\n",
+                    XMLString::to_stdstring (ex.getMessage ()).c_str ());
+
+        throw std::runtime_error (err.c_str ());
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+XMLCursor::~XMLCursor () throw ()  {
+
+    close ();
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLCursor::close ()  {
+
+    if (open_)  {
+        open_ = false;
+        parser_->parseReset (token_);
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLCursor::start_ ()  {
+
+    close ();
+    has_problem_ = false;
+    got_event_ = false;
+    have_event_ = false;
+    pending_end_ = false;
+    skipping_ = false;
+    event_ = ce_end_document;
+    depth_ = 0;
+    open_depth_ = 0;
+    attr_count_ = 0;
+    warning_msgs_.clear ();
+    error_msgs_.clear ();
+    fatal_error_.clear ();
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Runs the first scan of a document, from source or from file.
+// It goes through the prolog and may already deliver the root element.
+//
+bool XMLCursor::
+first_ (const XERCES_CPP_NAMESPACE::InputSource *source,
+        const char *const file)  {
+
+    open_ = true;
+
+    try  {
+        const   bool    started = source != NULL
+            ? parser_->parseFirst (*source, token_)
+            : parser_->parseFirst (file, token_);
+
+        if (! started || has_problem_)  {
+            close ();
+            return (false);
+        }
+    }
+    catch (const XERCES_CPP_NAMESPACE::SAXException &ex)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLCursor::first_(): SAX exception thrown. "
+                    "Message: '%s'\n",
+                    XMLString::to_stdstring (ex.getMessage ()).c_str ());
+
+        has_problem_ = true;
+        close ();
+        throw std::runtime_error (err.c_str ());
+    }
+    catch (const std::exception &ex)  {
+        has_problem_ = true;
+        close ();
+        throw;
+    }
+    catch (...)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLCursor::first_(): An unknown exception was "
+                    "thrown during parsing.\n"
+                    "No further information is available.");
+
+        has_problem_ = true;
+        close ();
+        throw std::runtime_error (err.c_str ());
+    }
+
+    have_event_ = got_event_;
+    return (true);
+}
+
+// ----------------------------------------------------------------------------
+
+// Scans the next token of the document. It returns false at the end of the
+// document, or if there was a fatal error.
+//
+bool XMLCursor::scan_ ()  {
+
+    bool    more = false;
+
+    try  {
+        more = parser_->parseNext (token_);
+    }
+    catch (const XERCES_CPP_NAMESPACE::SAXException &ex)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLCursor::scan_(): SAX exception thrown. "
+                    "Message: '%s'\n",
+                    XMLString::to_stdstring (ex.getMessage ()).c_str ());
+
+        has_problem_ = true;
+        close ();
+        throw std::runtime_error (err.c_str ());
+    }
+    catch (const std::exception &ex)  {
+        has_problem_ = true;
+        close ();
+        throw;
+    }
+    catch (...)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLCursor::scan_(): An unknown exception was "
+                    "thrown during parsing.\n"
+                    "No further information is available.");
+
+        has_problem_ = true;
+        close ();
+        throw std::runtime_error (err.c_str ());
+    }
+
+    if (! more || has_problem_)  {
+        if (more)
+            close ();
+        else  // The scanner is done with the document already
+            open_ = false;
+        event_ = ce_end_document;
+        depth_ = 0;
+        attr_count_ = 0;
+        return (false);
+    }
+
+    return (true);
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLCursor::open_string (const char *const xml,
+                             std::size_t xml_len,
+                             const char *const sys_id)  {
+
+    start_ ();
+    mem_buf_.reset (xml, xml_len, sys_id);
+    return (first_ (&mem_buf_, NULL));
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLCursor::open_file (const char *const file)  {
+
+    start_ ();
+    return (first_ (NULL, file));
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLCursor::open_callback (const XMLReadCallback &read_cb,
+                               const char *const sys_id)  {
+
+    start_ ();
+    callback_source_.reset (
+        new XMLCallbackInputSource (read_cb, sys_id, mem_manager_.get ()));
+    return (first_ (callback_source_.get (), NULL));
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLCursor::open_stream (std::istream &is, const char *const sys_id)  {
+
+    return (open_callback (XMLmake_decompress_reader (
+                               XMLmake_stream_reader (is)),
+                           sys_id));
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLCursor::open_fd (int fd, const char *const sys_id)  {
+
+    return (open_callback (XMLmake_decompress_reader (XMLmake_fd_reader (fd)),
+                           sys_id));
+}
+
+// ----------------------------------------------------------------------------
+
+XMLCursor::Event XMLCursor::next ()  {
+
+    if (have_event_)  {
+        have_event_ = false;
+        return (event_);
+    }
+    if (pending_end_)  {
+        pending_end_ = false;
+        event_ = ce_end_element;
+        attr_count_ = 0;
+        return (event_);
+    }
+    if (! open_)  {
+        event_ = ce_end_document;
+        depth_ = 0;
+        attr_count_ = 0;
+        return (event_);
+    }
+
+   // A scan may go through character data, comments, ... without
+   // producing an event
+   //
+    got_event_ = false;
+    while (! got_event_)
+        if (! scan_ ())
+            break;
+
+    return (event_);
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLCursor::skip_subtree ()  {
+
+    if (event_ != ce_start_element || have_event_)
+        return (false);
+    if (pending_end_)  {  // Empty element
+        pending_end_ = false;
+        event_ = ce_end_element;
+        attr_count_ = 0;
+        return (true);
+    }
+    if (! open_)
+        return (false);
+
+    skipping_ = true;
+    got_event_ = false;
+    while (! got_event_)
+        if (! scan_ ())  {
+            skipping_ = false;
+            return (false);
+        }
+
+    return (true);
+}
+
+// ----------------------------------------------------------------------------
+
+const char *XMLCursor::attr (const char *const name) const throw ()  {
+
+    for (size_type i = 0; i < attr_count_; ++i)
+        if (! ::strcmp (attrs_ [i].get_name (), name))
+            return (attrs_ [i].get_value ());
+
+    return (NULL);
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLCursor::set_name_ (const XMLCh *const name)  {
+
+    XMLString::size_type    len = 0;
+
+    if (XMLString::ascii_len (name, len))  {
+        name_.resize (len);
+        XMLString::narrow_ascii (name, &(name_ [0]), len);
+    }
+    else
+        XMLString::to_stdstring (name_, name);
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLCursor::
+startElement (const XMLCh *const name, AttributeList &attributes) throw ()  {
+
+    open_depth_ += 1;
+    if (skipping_)
+        return;
+
+    const   size_type   attr_size = attributes.getLength ();
+
+   // The name and attribute buffers are reused. They only grow.
+   //
+    set_name_ (name);
+    if (attrs_.size () < attr_size)
+        attrs_.resize (attr_size);
+    for (size_type i = 0; i < attr_size; ++i)
+        attrs_ [i].set_name_value (attributes.getName (i),
+                                   attributes.getValue (i));
+    attr_count_ = attr_size;
+
+    event_ = ce_start_element;
+    depth_ = open_depth_;
+    got_event_ = true;
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLCursor::endElement (const XMLCh *const name) throw ()  {
+
+    if (skipping_)  {
+        if (open_depth_ == depth_)  {  // The end of the skipped element
+            skipping_ = false;
+            event_ = ce_end_element;
+            attr_count_ = 0;
+            got_event_ = true;
+        }
+    }
+
+   // The start and end of an empty element come in the same scan. The end
+   // is handed out by the next call to next().
+   //
+    else if (got_event_)
+        pending_end_ = true;
+    else  {
+        set_name_ (name);
+        event_ = ce_end_element;
+        depth_ = open_depth_;
+        attr_count_ = 0;
+        got_event_ = true;
+    }
+
+    open_depth_ -= 1;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLCursor::warning (const SAXParseException &e) throw ()  {
+
+    warning_msgs_.push_back (XMLparse_error_text ("WARNING", e));
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// A recoverable error, e.g. a validation error. The document goes on.
+//
+void XMLCursor::error (const SAXParseException &e) throw ()  {
+
+    error_msgs_.push_back (XMLparse_error_text ("ERROR", e));
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLCursor::fatalError (const SAXParseException &e) throw ()  {
+
+    has_problem_ = true;
+    fatal_error_ = XMLparse_error_text ("FATAL ERROR", e);
+    return;
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,763 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string.h>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#ifdef XMLPARSER_HAVE_ZLIB
+#  include <zlib.h>
+#endif // XMLPARSER_HAVE_ZLIB
+#ifdef XMLPARSER_HAVE_ZSTD
+#  include <zstd.h>
+#endif // XMLPARSER_HAVE_ZSTD
+
+#include <DMScu_FixedSizeString.h>
+
+#include <XMLInputSources.h>
+#include <XMLString.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+XMLReadCallback XMLmake_stream_reader (std::istream &is)  {
+
+    return ([&is] (char *buffer, std::size_t max_size) -> long  {
+        if (is.bad ())
+            return (-1);
+
+        is.read (buffer, max_size);
+        return (is.bad () ? -1 : long (is.gcount ()));
+    });
+}
+
+// ----------------------------------------------------------------------------
+
+XMLReadCanceller::XMLReadCanceller () : cancelled_ (false)  {
+
+    if (::pipe (pipe_) != 0)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLReadCanceller::XMLReadCanceller(): pipe() failed. "
+                    "errno: %d (%s)", errno, ::strerror (errno));
+        throw std::runtime_error (err.c_str ());
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+XMLReadCanceller::~XMLReadCanceller () throw ()  {
+
+    ::close (pipe_ [0]);
+    ::close (pipe_ [1]);
+}
+
+// ----------------------------------------------------------------------------
+
+// The byte is never read, so the read end stays readable for good
+//
+void XMLReadCanceller::cancel () throw ()  {
+
+    if (! cancelled_.exchange (true))  {
+        const   char    byte = 0;
+        ssize_t         ret;
+
+        do
+            ret = ::write (pipe_ [1], &byte, 1);
+        while (ret < 0 && errno == EINTR);
+    }
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Waits until fd is readable or canceller (if not NULL) is cancelled.
+// It returns false with errno set, if it is cancelled or poll() fails.
+//
+static bool
+wait_readable_ (int fd, const XMLReadCanceller *canceller) throw ()  {
+
+    struct pollfd   pfds [2] = {
+        { fd, POLLIN, 0 },
+        { canceller != NULL ? canceller->get_fd () : -1, POLLIN, 0 }
+    };
+
+    for (;;)  {
+        if (::poll (pfds, canceller != NULL ? 2 : 1, -1) < 0)  {
+            if (errno == EINTR)
+                continue;
+            return (false);
+        }
+        if (canceller != NULL && pfds [1].revents != 0)  {
+            errno = ECANCELED;
+            return (false);
+        }
+        return (true);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+static long read_fd_ (int fd,
+                      char *buffer,
+                      std::size_t max_size,
+                      const XMLReadCanceller *canceller) throw ()  {
+
+    for (;;)  {
+        if (canceller != NULL && ! wait_readable_ (fd, canceller))
+            return (-1);
+
+        const   ssize_t ret = ::read (fd, buffer, max_size);
+
+        if (ret >= 0)
+            return (ret);
+        if (errno == EINTR)
+            continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            return (-1);
+        if (canceller == NULL && ! wait_readable_ (fd, NULL))
+            return (-1);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+XMLReadCallback
+XMLmake_fd_reader (int fd,
+                   std::size_t will_need,
+                   const std::shared_ptr<XMLReadCanceller> &canceller)  {
+
+   // Reads of regular files don't block for good, and polling them is
+   // pointless
+   //
+    struct  stat                        fd_stat;
+    std::shared_ptr<XMLReadCanceller>   poll_canceller;
+
+    if (canceller && (::fstat (fd, &fd_stat) != 0 ||
+                      ! S_ISREG (fd_stat.st_mode)))
+        poll_canceller = canceller;
+
+    if (will_need == 0)
+        return ([fd, poll_canceller] (char *buffer, std::size_t max_size)
+                    -> long  {
+            return (read_fd_ (fd, buffer, max_size, poll_canceller.get ()));
+        });
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise (fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif // POSIX_FADV_SEQUENTIAL
+
+    off_t   offset = ::lseek (fd, 0, SEEK_CUR);
+
+    return ([fd, will_need, offset, poll_canceller]
+                (char *buffer, std::size_t max_size) mutable -> long  {
+        const   long    ret =
+            read_fd_ (fd, buffer, max_size, poll_canceller.get ());
+
+#ifdef POSIX_FADV_WILLNEED
+        if (ret > 0 && offset >= 0)  {
+            offset += ret;
+            ::posix_fadvise (fd, offset, will_need, POSIX_FADV_WILLNEED);
+        }
+#endif // POSIX_FADV_WILLNEED
+
+        return (ret);
+    });
+}
+
+// ----------------------------------------------------------------------------
+
+XMLCompression
+XMLsniff_compression (const char *buffer, std::size_t size) throw ()  {
+
+    const   unsigned char   *const  ubuf =
+        reinterpret_cast<const unsigned char *>(buffer);
+
+    if (size >= 2 && ubuf [0] == 0x1F && ubuf [1] == 0x8B)
+        return (xml_gzip);
+    if (size >= 4 &&
+        ubuf [0] == 0x28 && ubuf [1] == 0xB5 &&
+        ubuf [2] == 0x2F && ubuf [3] == 0xFD)
+        return (xml_zstd);
+    return (xml_no_compression);
+}
+
+// ----------------------------------------------------------------------------
+
+// The state behind a decompress reader. It is shared by all the copies of
+// the returned callback.
+//
+class   XMLDecompressReader_  {
+
+    public:
+
+        explicit XMLDecompressReader_ (const XMLReadCallback &raw_cb)
+            : raw_cb_ (raw_cb),
+              in_buf_ (in_buf_size_),
+              in_pos_ (0),
+              in_len_ (0),
+              in_eof_ (false),
+              sniffed_ (false),
+              compression_ (xml_no_compression)  {
+
+#ifdef XMLPARSER_HAVE_ZLIB
+            ::memset (&zstream_, 0, sizeof (zstream_));
+            zstream_init_ = false;
+            member_end_ = false;
+#endif // XMLPARSER_HAVE_ZLIB
+#ifdef XMLPARSER_HAVE_ZSTD
+            dstream_ = NULL;
+            frame_remaining_ = 0;
+#endif // XMLPARSER_HAVE_ZSTD
+        }
+
+        ~XMLDecompressReader_ ()  {
+
+#ifdef XMLPARSER_HAVE_ZLIB
+            if (zstream_init_)
+                ::inflateEnd (&zstream_);
+#endif // XMLPARSER_HAVE_ZLIB
+#ifdef XMLPARSER_HAVE_ZSTD
+            if (dstream_ != NULL)
+                ::ZSTD_freeDStream (dstream_);
+#endif // XMLPARSER_HAVE_ZSTD
+        }
+
+        long read (char *buffer, std::size_t max_size)  {
+
+            if (! sniffed_)  {
+                while (in_len_ < 4 && ! in_eof_)
+                    if (fill_ () < 0)
+                        return (-1);
+                compression_ = XMLsniff_compression (&(in_buf_ [0]), in_len_);
+                start_ ();
+                sniffed_ = true;
+            }
+
+            switch (compression_)  {
+#ifdef XMLPARSER_HAVE_ZLIB
+                case xml_gzip: return (inflate_ (buffer, max_size));
+#endif // XMLPARSER_HAVE_ZLIB
+#ifdef XMLPARSER_HAVE_ZSTD
+                case xml_zstd: return (decompress_zstd_ (buffer, max_size));
+#endif // XMLPARSER_HAVE_ZSTD
+                default: return (pass_through_ (buffer, max_size));
+            }
+        }
+
+    private:
+
+        static  const   std::size_t in_buf_size_ = 64 * 1024;
+
+        XMLReadCallback     raw_cb_;
+        std::vector<char>   in_buf_;
+        std::size_t         in_pos_;
+        std::size_t         in_len_;
+        bool                in_eof_;
+        bool                sniffed_;
+        XMLCompression      compression_;
+
+#ifdef XMLPARSER_HAVE_ZLIB
+        z_stream    zstream_;
+        bool        zstream_init_;
+        bool        member_end_;
+#endif // XMLPARSER_HAVE_ZLIB
+#ifdef XMLPARSER_HAVE_ZSTD
+        ZSTD_DStream    *dstream_;
+        std::size_t     frame_remaining_;
+#endif // XMLPARSER_HAVE_ZSTD
+
+       // Reads more raw input behind what is not consumed yet
+       //
+        long fill_ ()  {
+
+            if (in_pos_ == in_len_)
+                in_pos_ = in_len_ = 0;
+
+            const   long    ret = raw_cb_ (&(in_buf_ [in_len_]),
+                                           in_buf_.size () - in_len_);
+
+            if (ret == 0)
+                in_eof_ = true;
+            else if (ret > 0)
+                in_len_ += ret;
+            return (ret);
+        }
+
+        void start_ ()  {
+
+            DMScu_FixedSizeString<1023> err;
+
+            switch (compression_)  {
+                case xml_gzip:
+#ifdef XMLPARSER_HAVE_ZLIB
+                   // 15 + 32: maximum window and gzip/zlib header detection
+                   //
+                    if (::inflateInit2 (&zstream_, 15 + 32) != Z_OK)  {
+                        err.printf ("XMLDecompressReader::start_(): "
+                                    "inflateInit2() failed.");
+                        throw std::runtime_error (err.c_str ());
+                    }
+                    zstream_init_ = true;
+                    return;
+#else
+                    err.printf ("XMLDecompressReader::start_(): "
+                                "The input is gzip compressed, but the "
+                                "library was built without "
+                                "XMLPARSER_HAVE_ZLIB.");
+                    throw std::runtime_error (err.c_str ());
+#endif // XMLPARSER_HAVE_ZLIB
+                case xml_zstd:
+#ifdef XMLPARSER_HAVE_ZSTD
+                    dstream_ = ::ZSTD_createDStream ();
+                    if (dstream_ == NULL ||
+                        ::ZSTD_isError (::ZSTD_initDStream (dstream_)))  {
+                        err.printf ("XMLDecompressReader::start_(): "
+                                    "ZSTD_initDStream() failed.");
+                        throw std::runtime_error (err.c_str ());
+                    }
+                    return;
+#else
+                    err.printf ("XMLDecompressReader::start_(): "
+                                "The input is zstd compressed, but the "
+                                "library was built without "
+                                "XMLPARSER_HAVE_ZSTD.");
+                    throw std::runtime_error (err.c_str ());
+#endif // XMLPARSER_HAVE_ZSTD
+                default:
+                    return;
+            }
+        }
+
+       // Hands out what was read for sniffing, and then reads straight into
+       // the caller's buffer.
+       //
+        long pass_through_ (char *buffer, std::size_t max_size)  {
+
+            if (in_pos_ < in_len_)  {
+                const   std::size_t size =
+                    std::min (max_size, in_len_ - in_pos_);
+
+                ::memcpy (buffer, &(in_buf_ [in_pos_]), size);
+                in_pos_ += size;
+                return (size);
+            }
+            if (in_eof_)
+                return (0);
+            return (raw_cb_ (buffer, max_size));
+        }
+
+        static void truncated_ (const char *const msg)  {
+
+            throw std::runtime_error (msg);
+        }
+
+#ifdef XMLPARSER_HAVE_ZLIB
+        long inflate_ (char *buffer, std::size_t max_size)  {
+
+            for (;;)  {
+                if (in_pos_ == in_len_ && ! in_eof_ && fill_ () < 0)
+                    return (-1);
+                if (member_end_)  {
+                    if (in_pos_ == in_len_)
+                        return (0);
+
+                   // Another gzip member follows
+                   //
+                    ::inflateReset (&zstream_);
+                    member_end_ = false;
+                }
+
+                zstream_.next_in =
+                    reinterpret_cast<Bytef *>(&(in_buf_ [in_pos_]));
+                zstream_.avail_in = uInt (in_len_ - in_pos_);
+                zstream_.next_out = reinterpret_cast<Bytef *>(buffer);
+                zstream_.avail_out = uInt (max_size);
+
+                const   int ret = ::inflate (&zstream_, Z_NO_FLUSH);
+
+                in_pos_ = in_len_ - zstream_.avail_in;
+                if (ret == Z_STREAM_END)
+                    member_end_ = true;
+                else if (ret == Z_BUF_ERROR)  {
+                    if (in_pos_ == in_len_ && in_eof_)
+                        truncated_ ("XMLDecompressReader::inflate_(): "
+                                    "The gzip input is truncated.");
+                }
+                else if (ret != Z_OK)  {
+                    DMScu_FixedSizeString<1023> err;
+
+                    err.printf ("XMLDecompressReader::inflate_(): "
+                                "inflate() failed with %d (%s)", ret,
+                                zstream_.msg ? zstream_.msg : "no message");
+                    throw std::runtime_error (err.c_str ());
+                }
+
+                const   std::size_t produced = max_size - zstream_.avail_out;
+
+                if (produced > 0)
+                    return (produced);
+            }
+        }
+#endif // XMLPARSER_HAVE_ZLIB
+
+#ifdef XMLPARSER_HAVE_ZSTD
+        long decompress_zstd_ (char *buffer, std::size_t max_size)  {
+
+            for (;;)  {
+                if (in_pos_ == in_len_ && ! in_eof_ && fill_ () < 0)
+                    return (-1);
+
+                ZSTD_inBuffer   in = { &(in_buf_ [0]), in_len_, in_pos_ };
+                ZSTD_outBuffer  out = { buffer, max_size, 0 };
+
+                frame_remaining_ =
+                    ::ZSTD_decompressStream (dstream_, &out, &in);
+                in_pos_ = in.pos;
+                if (::ZSTD_isError (frame_remaining_))  {
+                    DMScu_FixedSizeString<1023> err;
+
+                    err.printf ("XMLDecompressReader::decompress_zstd_(): "
+                                "ZSTD_decompressStream() failed (%s)",
+                                ::ZSTD_getErrorName (frame_remaining_));
+                    throw std::runtime_error (err.c_str ());
+                }
+                if (out.pos > 0)
+                    return (out.pos);
+                if (in_pos_ == in_len_ && in_eof_)  {
+                    if (frame_remaining_ != 0)
+                        truncated_ ("XMLDecompressReader::decompress_zstd_(): "
+                                    "The zstd input is truncated.");
+                    return (0);
+                }
+            }
+        }
+#endif // XMLPARSER_HAVE_ZSTD
+};
+
+// ----------------------------------------------------------------------------
+
+XMLReadCallback XMLmake_decompress_reader (const XMLReadCallback &raw_cb)  {
+
+    const   std::shared_ptr<XMLDecompressReader_>   reader =
+        std::make_shared<XMLDecompressReader_> (raw_cb);
+
+    return ([reader] (char *buffer, std::size_t max_size) -> long  {
+        return (reader->read (buffer, max_size));
+    });
+}
+
+// ----------------------------------------------------------------------------
+
+// The state behind a prefetch reader. The producer thread fills the two
+// buffers in turn; the reading side drains them in the same order.
+//
+class   XMLPrefetchReader_  {
+
+    public:
+
+        XMLPrefetchReader_ (
+            const XMLReadCallback &src_cb,
+            std::size_t buffer_size,
+            unsigned long long *stall_ns,
+            const std::shared_ptr<XMLReadCanceller> &canceller)
+            : src_cb_ (src_cb),
+              canceller_ (canceller),
+              stall_ns_ (stall_ns),
+              read_idx_ (0),
+              read_pos_ (0),
+              src_done_ (false),
+              src_errno_ (0),
+              stop_ (false)  {
+
+            for (int i = 0; i < 2; ++i)  {
+                buffers_ [i].resize (buffer_size);
+                lengths_ [i] = 0;
+                full_ [i] = false;
+            }
+            thread_ = std::thread (&XMLPrefetchReader_::produce_, this);
+        }
+
+        ~XMLPrefetchReader_ ()  {
+
+            {
+                const   std::lock_guard<std::mutex> guard (mutex_);
+
+                stop_ = true;
+            }
+            if (canceller_)
+                canceller_->cancel ();
+            cond_.notify_all ();
+            thread_.join ();
+        }
+
+        long read (char *buffer, std::size_t max_size)  {
+
+            std::unique_lock<std::mutex>    guard (mutex_);
+
+            if (! full_ [read_idx_] && ! src_done_)  {
+                const   std::chrono::steady_clock::time_point   start =
+                    std::chrono::steady_clock::now ();
+
+                cond_.wait (guard, [this] () -> bool  {
+                    return (full_ [read_idx_] || src_done_);
+                });
+                if (stall_ns_ != NULL)
+                    *stall_ns_ +=
+                        std::chrono::duration_cast<std::chrono::nanoseconds>
+                            (std::chrono::steady_clock::now () - start).
+                                count ();
+            }
+            if (! full_ [read_idx_])  {  // Producer is done and drained
+                if (src_error_)
+                    std::rethrow_exception (src_error_);
+                if (src_errno_ != 0)  {
+                    errno = src_errno_;
+                    return (-1);
+                }
+                return (0);
+            }
+            guard.unlock ();
+
+           // The reading side owns a full buffer, until it marks it empty
+           //
+            const   std::size_t size =
+                std::min (max_size, lengths_ [read_idx_] - read_pos_);
+
+            ::memcpy (buffer, &(buffers_ [read_idx_][read_pos_]), size);
+            read_pos_ += size;
+            if (read_pos_ == lengths_ [read_idx_])  {
+                guard.lock ();
+                full_ [read_idx_] = false;
+                guard.unlock ();
+                cond_.notify_all ();
+                read_idx_ ^= 1;
+                read_pos_ = 0;
+            }
+            return (size);
+        }
+
+    private:
+
+        XMLReadCallback                     src_cb_;
+        std::shared_ptr<XMLReadCanceller>   canceller_;
+        unsigned long long                  *stall_ns_;
+        std::vector<char>                   buffers_ [2];
+        std::size_t                         lengths_ [2];
+        bool                                full_ [2];
+        int                                 read_idx_;
+        std::size_t                         read_pos_;
+        bool                                src_done_;
+        int                                 src_errno_;
+        std::exception_ptr                  src_error_;
+        bool                                stop_;
+        std::mutex                          mutex_;
+        std::condition_variable             cond_;
+        std::thread                         thread_;
+
+        void produce_ ()  {
+
+            int fill_idx = 0;
+
+            for (;;)  {
+                {
+                    std::unique_lock<std::mutex>    guard (mutex_);
+
+                    cond_.wait (guard, [this, fill_idx] () -> bool  {
+                        return (! full_ [fill_idx] || stop_);
+                    });
+                    if (stop_)
+                        return;
+                }
+
+               // The producer owns an empty buffer, until it marks it full.
+               // It is handed over after one read, even if it is not filled
+               // up, since the next read may block for a while on a pipe or
+               // a socket.
+               //
+                std::vector<char>   &buffer = buffers_ [fill_idx];
+                std::size_t         length = 0;
+                bool                done = false;
+                int                 error_no = 0;
+                std::exception_ptr  error;
+
+                try  {
+                    const   long    ret =
+                        src_cb_ (&(buffer [0]), buffer.size ());
+
+                    if (ret > 0)
+                        length = ret;
+                    else  {
+                        if (ret < 0)
+                            error_no = errno ? errno : EIO;
+                        done = true;
+                    }
+                }
+                catch (...)  {
+                    error = std::current_exception ();
+                    done = true;
+                }
+
+                {
+                    const   std::lock_guard<std::mutex> guard (mutex_);
+
+                    if (length > 0)  {
+                        lengths_ [fill_idx] = length;
+                        full_ [fill_idx] = true;
+                    }
+                    if (done)  {
+                        src_done_ = true;
+                        src_errno_ = error_no;
+                        src_error_ = error;
+                    }
+                }
+                cond_.notify_all ();
+                if (done)
+                    return;
+                fill_idx ^= 1;
+            }
+        }
+};
+
+// ----------------------------------------------------------------------------
+
+XMLReadCallback
+XMLmake_prefetch_reader (const XMLReadCallback &src_cb,
+                         std::size_t buffer_size,
+                         unsigned long long *stall_ns,
+                         const std::shared_ptr<XMLReadCanceller> &canceller)  {
+
+    const   std::shared_ptr<XMLPrefetchReader_> reader =
+        std::make_shared<XMLPrefetchReader_> (src_cb, buffer_size, stall_ns,
+                                              canceller);
+
+    return ([reader] (char *buffer, std::size_t max_size) -> long  {
+        return (reader->read (buffer, max_size));
+    });
+}
+
+// ----------------------------------------------------------------------------
+
+XMLCallbackInputStream::
+XMLCallbackInputStream (const XMLReadCallback &read_cb,
+                        XMLFilePos *bytes_read) throw ()
+    : read_cb_ (read_cb), pos_ (0), bytes_read_ (bytes_read)  {
+
+    if (bytes_read_ != NULL)
+        *bytes_read_ = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+XMLFilePos XMLCallbackInputStream::curPos () const  {
+
+    return (pos_);
+}
+
+// ----------------------------------------------------------------------------
+
+XMLSize_t XMLCallbackInputStream::
+readBytes (XMLByte *const to_fill, const XMLSize_t max_read)  {
+
+    const   long    ret = read_cb_ (reinterpret_cast<char *>(to_fill),
+                                    max_read);
+
+    if (ret < 0)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLCallbackInputStream::readBytes(): "
+                    "Read failed at position %llu. errno: %d (%s)",
+                    static_cast<unsigned long long>(pos_),
+                    errno, ::strerror (errno));
+
+        throw std::runtime_error (err.c_str ());
+    }
+
+    pos_ += ret;
+    if (bytes_read_ != NULL)
+        *bytes_read_ = pos_;
+
+    return (ret);
+}
+
+// ----------------------------------------------------------------------------
+
+const XMLCh *XMLCallbackInputStream::getContentType () const  {
+
+    return (NULL);
+}
+
+// ----------------------------------------------------------------------------
+
+XMLCallbackInputSource::
+XMLCallbackInputSource (const XMLReadCallback &read_cb,
+                        const char *const sys_id,
+                        XERCES_CPP_NAMESPACE::MemoryManager *const mem_manager)
+    : XERCES_CPP_NAMESPACE::InputSource (sys_id, mem_manager),
+      read_cb_ (read_cb),
+      bytes_read_ (0)  {
+}
+
+// ----------------------------------------------------------------------------
+
+XERCES_CPP_NAMESPACE::BinInputStream *
+XMLCallbackInputSource::makeStream () const  {
+
+    return (new (getMemoryManager ())
+                XMLCallbackInputStream (read_cb_, &bytes_read_));
+}
+
+// ----------------------------------------------------------------------------
+
+XMLMemBufInputSource::
+XMLMemBufInputSource (XERCES_CPP_NAMESPACE::MemoryManager *const mem_manager)
+    : XERCES_CPP_NAMESPACE::MemBufInputSource (NULL, 0, "default", false,
+                                               mem_manager),
+      sys_id_ ("default")  {
+
+    setCopyBufToStream (false);
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLMemBufInputSource::reset (const char *const xml,
+                                  std::size_t xml_len,
+                                  const char *const sys_id)  {
+
+    if (sys_id_ != sys_id)  {
+        const   XMLString   xml_sys_id (sys_id);
+
+        setSystemId (xml_sys_id.c_str ());
+        sys_id_ = sys_id;
+    }
+    resetMemBufInputSource (reinterpret_cast<const XMLByte *>(xml),
+                            xml_len);
+
+    return;
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,122 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <cerrno>
+#include <climits>
+#include <stdexcept>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <DMScu_FixedSizeString.h>
+
+#include <XMLIovecSink.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+XMLIovecSink::XMLIovecSink (int fd,
+                            size_type scratch_size,
+                            size_type copy_limit)
+    : fd_ (fd),
+      copy_limit_ (copy_limit),
+      max_iovecs_ (IOV_MAX),
+      scratch_ (scratch_size > 0 ? scratch_size : 1),
+      scratch_used_ (0),
+      pending_ (0),
+      written_ (0)  {
+
+    iovecs_.reserve (max_iovecs_);
+}
+
+// ----------------------------------------------------------------------------
+
+XMLIovecSink::~XMLIovecSink () throw ()  {   }
+
+// ----------------------------------------------------------------------------
+
+// Runs of spaces are referred to in a static buffer
+//
+void XMLIovecSink::spaces (size_type count)  {
+
+    static  const   char    blanks [] =
+        "                                                                ";
+    const   size_type       chunk = sizeof (blanks) - 1;
+
+    for ( ; count > chunk; count -= chunk)
+        put (blanks, chunk);
+    put (blanks, count);
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// writev() may write only part of the batch. The iovecs that are done are
+// skipped, and the one that is partly done is trimmed, before trying again.
+// On an error, the skipped iovecs are dropped, so the batch holds exactly
+// what is not written yet.
+//
+void XMLIovecSink::flush ()  {
+
+    struct iovec    *iov = iovecs_.empty () ? NULL : &(iovecs_ [0]);
+    size_type       count = iovecs_.size ();
+
+    while (count > 0)  {
+        const   ssize_t ret = ::writev (fd_, iov, int (count));
+
+        if (ret < 0)  {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)  {
+                struct pollfd   pfd = { fd_, POLLOUT, 0 };
+
+                if (::poll (&pfd, 1, -1) >= 0 || errno == EINTR)
+                    continue;
+            }
+
+            const   int                 error_no = errno;
+            DMScu_FixedSizeString<1023> err;
+
+            iovecs_.erase (iovecs_.begin (), iovecs_.begin () +
+                                                 (iovecs_.size () - count));
+            err.printf ("XMLIovecSink::flush(): writev() failed on fd %d. "
+                        "errno: %d (%s)",
+                        fd_, error_no, ::strerror (error_no));
+            throw std::runtime_error (err.c_str ());
+        }
+
+        size_type   done = size_type (ret);
+
+        written_ += done;
+        pending_ -= done;
+        while (count > 0 && done >= iov->iov_len)  {
+            done -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0)  {
+            iov->iov_base = static_cast<char *>(iov->iov_base) + done;
+            iov->iov_len -= done;
+        }
+    }
+
+    iovecs_.clear ();
+    scratch_used_ = 0;
+    pending_ = 0;
+    return;
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,316 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <XMLParallelVisitor.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+XMLParallelVisitor::XMLParallelVisitor (size_type threads, size_type grain)
+    : grain_ (grain > 0 ? grain : 1),
+      pending_ (0),
+      idle_ (0),
+      sleeping_ (0),
+      abort_ (false),
+      task_func_ (NULL),
+      visit_ (0),
+      running_ (0),
+      stop_ (false)  {
+
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency ();
+    if (threads == 0)
+        threads = 1;
+
+    workers_.reserve (threads);
+    for (size_type i = 0; i < threads; ++i)
+        workers_.push_back (std::unique_ptr<Worker_> (new Worker_));
+
+   // The calling thread is worker 0. threads_ has room for all the others,
+   // so once a thread is started, it is in threads_ to be joined.
+   //
+    threads_.reserve (threads - 1);
+    try  {
+        for (size_type i = 1; i < threads; ++i)
+            threads_.push_back (
+                std::thread (&XMLParallelVisitor::thread_loop_, this, i));
+    }
+    catch (...)  {
+        stop_threads_ ();
+        throw;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+XMLParallelVisitor::~XMLParallelVisitor ()  {
+
+    stop_threads_ ();
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLParallelVisitor::stop_threads_ () throw ()  {
+
+    {
+        const   std::lock_guard<std::mutex> guard (mutex_);
+
+        stop_ = true;
+    }
+    start_cond_.notify_all ();
+    for (size_type i = 0; i < threads_.size (); ++i)
+        if (threads_ [i].joinable ())
+            threads_ [i].join ();
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLParallelVisitor::thread_loop_ (size_type worker)  {
+
+    size_type   visit = 0;
+
+    for (;;)  {
+        {
+            std::unique_lock<std::mutex>    lock (mutex_);
+
+            start_cond_.wait (lock, [this, visit] ()  {
+                return (stop_ || visit_ != visit);
+            });
+            if (stop_)
+                return;
+            visit = visit_;
+        }
+
+        work_ (worker);
+
+        {
+            const   std::lock_guard<std::mutex> guard (mutex_);
+
+            if (--running_ == 0)
+                done_cond_.notify_one ();
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// pending_ counts the task before any thread can take it
+//
+void XMLParallelVisitor::push_ (Worker_ &worker, const Task_ &task)  {
+
+    {
+        const   std::lock_guard<std::mutex> guard (worker.mutex);
+
+        worker.tasks.push_back (task);
+        pending_.fetch_add (1);
+        worker.queued.store (worker.tasks.size ());
+    }
+    wake_idle_ (false);
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// A sleeper counts itself in sleeping_ before it looks for tasks, and a
+// waker looks at sleeping_ after it has changed them. So either the sleeper
+// sees the change or the waker sees the sleeper.
+//
+void XMLParallelVisitor::wait_for_task_ ()  {
+
+    std::unique_lock<std::mutex>    lock (mutex_);
+
+    sleeping_.fetch_add (1);
+    for (;;)  {
+        bool    queued = pending_.load () == 0;
+
+        for (size_type i = 0; i < workers_.size () && ! queued; ++i)
+            queued = workers_ [i]->queued.load () != 0;
+        if (queued)
+            break;
+        task_cond_.wait (lock);
+    }
+    sleeping_.fetch_sub (1);
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLParallelVisitor::wake_idle_ (bool all)  {
+
+    if (sleeping_.load () != 0)  {
+        const   std::lock_guard<std::mutex> guard (mutex_);
+
+        if (all)
+            task_cond_.notify_all ();
+        else
+            task_cond_.notify_one ();
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLParallelVisitor::split_ (Worker_ &worker)  {
+
+    Level_                  &level = worker.path [worker.live];
+    const   XMLTreeNodes    *cut = level.node->get_sibling ();
+    size_type               ahead = 0;
+
+    for (const XMLTreeNodes *node = cut;
+         node != level.end && ahead < grain_; node = node->get_sibling ())
+        ahead += 1;
+    for (size_type i = 0; i < ahead / 2; ++i)
+        cut = cut->get_sibling ();
+
+    push_ (worker, Task_ { cut, level.end });
+    if (cut == level.node->get_sibling ())
+        worker.live += 1;  // None of them is kept
+    else
+        level.end = cut;
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Takes the newest task of our own, or else the oldest task of another
+// worker
+//
+bool XMLParallelVisitor::take_ (size_type worker, Task_ &task)  {
+
+    for (size_type i = 0; i < workers_.size (); ++i)  {
+        Worker_                         &w =
+            *(workers_ [(worker + i) % workers_.size ()]);
+        const   std::lock_guard<std::mutex> guard (w.mutex);
+
+        if (! w.tasks.empty ())  {
+            if (i == 0)  {
+                task = w.tasks.back ();
+                w.tasks.pop_back ();
+            }
+            else  {
+                task = w.tasks.front ();
+                w.tasks.pop_front ();
+            }
+            w.queued.store (w.tasks.size (), std::memory_order_relaxed);
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+// ----------------------------------------------------------------------------
+
+// Tasks are added while the visit runs, so a thread is done only when no
+// task is queued or running anywhere. Until then, it keeps looking and
+// counts itself idle, which makes the busy threads split their tasks.
+// After a functor has thrown, the rest of the tasks are taken but not run.
+//
+void XMLParallelVisitor::work_ (size_type worker)  {
+
+    Worker_     &w = *(workers_ [worker]);
+    Task_       task;
+    bool        idle = false;
+    size_type   tries = 0;
+
+    for (;;)  {
+        if (take_ (worker, task))  {
+            if (idle)  {
+                idle_.fetch_sub (1);
+                idle = false;
+            }
+            if (! abort_.load (std::memory_order_relaxed))  {
+                try  {
+                    (*task_func_) (worker, task);
+                }
+                catch (...)  {
+                    if (! w.error)
+                        w.error = std::current_exception ();
+                    abort_.store (true);
+                }
+            }
+            if (pending_.fetch_sub (1) == 1)
+                wake_idle_ (true);
+        }
+        else if (pending_.load () == 0)
+            break;
+        else  {
+            if (! idle)  {
+                idle_.fetch_add (1);
+                idle = true;
+                tries = 0;
+            }
+            if (++tries < 64)
+                std::this_thread::yield ();
+            else  {
+                wait_for_task_ ();
+                tries = 0;
+            }
+        }
+    }
+    if (idle)
+        idle_.fetch_sub (1);
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLParallelVisitor::run_ (const XMLTreeNodes &root,
+                               const TaskFunc_ &task_func)  {
+
+    for (size_type i = 0; i < workers_.size (); ++i)  {
+        workers_ [i]->tasks.clear ();
+        workers_ [i]->queued.store (0);
+        workers_ [i]->error = std::exception_ptr ();
+    }
+    abort_.store (false);
+    idle_.store (0);
+    sleeping_.store (0);
+    pending_.store (0);
+    push_ (*(workers_ [0]), Task_ { &root, root.get_sibling () });
+
+    {
+        const   std::lock_guard<std::mutex> guard (mutex_);
+
+        task_func_ = &task_func;
+        running_ = threads_.size ();
+        visit_ += 1;
+    }
+    start_cond_.notify_all ();
+
+    work_ (0);
+
+    {
+        std::unique_lock<std::mutex>    lock (mutex_);
+
+        done_cond_.wait (lock, [this] ()  { return (running_ == 0); });
+        task_func_ = NULL;
+    }
+
+    for (size_type i = 0; i < workers_.size (); ++i)
+        if (workers_ [i]->error)
+            std::rethrow_exception (workers_ [i]->error);
+
+    return;
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
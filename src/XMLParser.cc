@@ -4,21 +4,35 @@
 // Distributed under the BSD Software License (see file License)
 
 #include <cstdio>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 #include <assert.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <xercesc/sax/AttributeList.hpp>
 #include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/internal/XMLGrammarPoolImpl.hpp>
 
 #include <DMScu_FixedSizeString.h>
 
 #include <XMLParser.h>
 #include <XMLString.h>
+#include <XMLXercesSupport.h>
 
 // ----------------------------------------------------------------------------
 
 namespace hmxml
 {
 
+XERCES_CPP_NAMESPACE::XMLGrammarPool   *XMLParser::grammar_pool_ = NULL;
+XMLParser::EntityMap                    XMLParser::local_entities_;
+std::list<std::string>                  XMLParser::local_contents_;
+std::mutex                              XMLParser::local_entities_mutex_;
+std::mutex                              XMLParser::parser_cache_mutex_;
+
 const   XMLParser::PP_Initializer   XMLParser::pp_initializer_;
 XMLParser::ParserVector             XMLParser::parser_cache_;
 
@@ -41,12 +55,20 @@ XMLParser::PP_Initializer::PP_Initializer ()  {
 
         throw std::runtime_error (err.c_str ());
     }
+
+    grammar_pool_ = new XERCES_CPP_NAMESPACE::XMLGrammarPoolImpl (
+        XERCES_CPP_NAMESPACE::XMLPlatformUtils::fgMemoryManager);
 }
 
 // ----------------------------------------------------------------------------
 
 XMLParser::PP_Initializer::~PP_Initializer ()  {
 
+   // By now, all the pooled parsers that use the grammar pool are gone
+   //
+    delete grammar_pool_;
+    grammar_pool_ = NULL;
+
     XERCES_CPP_NAMESPACE::XMLPlatformUtils::Terminate ();
 }
 
@@ -57,6 +79,8 @@ XMLParser::PP_Initializer::~PP_Initializer ()  {
 inline XMLParser::ParserStrap &XMLParser::
 get_available_parser_ () throw ()  {
 
+    const   std::lock_guard<std::mutex> guard (parser_cache_mutex_);
+
     for (ParserVector::iterator itr = parser_cache_.begin ();
          itr != parser_cache_.end (); ++itr)
         if (! (*itr)->busy)  {
@@ -64,7 +88,19 @@ get_available_parser_ () throw ()  {
             return (**itr);
         }
 
-    ParserStrap *ps = new ParserStrap (new SAXParser, true);
+   // Each pooled parser allocates from its own arena
+   //
+    XMLArenaMemoryManager   *mem_manager = new XMLArenaMemoryManager;
+    SAXParser               *parser =
+        new SAXParser (NULL, mem_manager, grammar_pool_);
+
+   // Only the preloaded grammars are used. Caching grammars from parses
+   // would mean writing to the shared pool from many threads.
+   //
+    parser->useCachedGrammarInParse (true);
+    parser->cacheGrammarFromParse (false);
+
+    ParserStrap *ps = new ParserStrap (parser, mem_manager, true);
 
     parser_cache_.push_back (ps);
 
@@ -77,7 +113,37 @@ get_available_parser_ () throw ()  {
 //
 XMLParser::~XMLParser () throw ()  {
 
-    my_parser_strap_.busy = false;
+   // Leave the pooled parser the way the next user expects it
+   //
+    if (low_latency_)  {
+        SAXParser   &parser = *(my_parser_strap_.parser);
+
+        parser.setValidationScheme (saved_settings_.validation_scheme);
+        parser.setDoSchema (saved_settings_.do_schema);
+        parser.setValidationSchemaFullChecking (saved_settings_.full_checking);
+        parser.setLoadExternalDTD (saved_settings_.load_external_dtd);
+        parser.setCalculateSrcOfs (saved_settings_.calculate_src_ofs);
+        parser.setExitOnFirstFatalError (
+            saved_settings_.exit_on_first_fatal_error);
+    }
+
+   // Recycled nodes have neither child nor sibling anymore
+   //
+    for (std::vector<XMLTreeNodes *>::const_iterator itr =
+             node_pool_.begin ();
+         itr != node_pool_.end (); ++itr)
+        delete *itr;
+
+   // The arena of the pooled parser is not thread-safe. Everything that
+   // allocated from it must be gone, before another thread can take it.
+   //
+    mem_buf_.reset ();
+
+    {
+        const   std::lock_guard<std::mutex> guard (parser_cache_mutex_);
+
+        my_parser_strap_.busy = false;
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -87,18 +153,29 @@ XMLParser::XMLParser (XMLTreeNodes &i_n,
                               SAXParser::ValSchemes vs,
                               bool do_namespace)
     : has_problem_ (false),
-      just_opened_element_ (NULL),
-      just_closed_element_ (NULL),
       started_ (false),
+      low_latency_ (false),
+      threaded_input_ (false),
+      file_input_ (fi_xerces),
+      read_ahead_size_ (1024 * 1024),
+      input_stall_ns_ (0),
+      saved_settings_ (),
+      just_closed_element_ (NULL),
+      just_opened_element_ (NULL),
       initial_node_ (i_n),
       attr_vector_ (attr_vector),
-      my_parser_strap_ (get_available_parser_ ())  {
+      stats_ (NULL),
+      handler_ns_ (0),
+      transcoding_ns_ (0),
+      my_parser_strap_ (get_available_parser_ ()),
+      mem_buf_ (new XMLMemBufInputSource (my_parser_strap_.mem_manager))  {
 
     try  {
         my_parser_strap_.parser->setValidationScheme (vs);
         my_parser_strap_.parser->setDoNamespaces (do_namespace);
         my_parser_strap_.parser->setDocumentHandler (this);
         my_parser_strap_.parser->setErrorHandler (this);
+        my_parser_strap_.parser->setEntityResolver (this);
     }
     catch (const XERCES_CPP_NAMESPACE::SAXException &ex)  {
         DMScu_FixedSizeString<1023> err;
@@ -114,6 +191,46 @@ XMLParser::XMLParser (XMLTreeNodes &i_n,
 
 // ----------------------------------------------------------------------------
 
+void XMLParser::set_low_latency_mode ()  {
+
+    SAXParser   &parser = *(my_parser_strap_.parser);
+
+    try  {
+        if (! low_latency_)  {
+            saved_settings_.validation_scheme = parser.getValidationScheme ();
+            saved_settings_.do_schema = parser.getDoSchema ();
+            saved_settings_.full_checking =
+                parser.getValidationSchemaFullChecking ();
+            saved_settings_.load_external_dtd = parser.getLoadExternalDTD ();
+            saved_settings_.calculate_src_ofs = parser.getCalculateSrcOfs ();
+            saved_settings_.exit_on_first_fatal_error =
+                parser.getExitOnFirstFatalError ();
+        }
+
+        parser.setValidationScheme (SAXParser::Val_Never);
+        parser.setDoSchema (false);
+        parser.setValidationSchemaFullChecking (false);
+        parser.setLoadExternalDTD (false);
+        parser.setCalculateSrcOfs (false);
+        parser.setExitOnFirstFatalError (true);
+    }
+    catch (const XERCES_CPP_NAMESPACE::SAXException &ex)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLParser::set_low_latency_mode(): "
+                    "ERROR during SAX Parser initialization. "
+                    "Message: '%s'\n",
+                    XMLString::to_stdstring (ex.getMessage ()).c_str ());
+
+        throw std::runtime_error (err.c_str ());
+    }
+
+    low_latency_ = true;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
 #ifdef XMLSPEED_IS_NO_ISSUE
 template <class xml_TYPE>
 class   xml_crude_auto_array_ptr  {
@@ -129,6 +246,54 @@ class   xml_crude_auto_array_ptr  {
 
 // ----------------------------------------------------------------------------
 
+template<typename xml_CHAR>
+inline XMLTreeNodes *
+XMLParser::new_node_ (const xml_CHAR *const name, size_type attr_size)  {
+
+    if (! started_)  {
+        started_ = true;
+        initial_node_.recycle (name, attr_size);
+        return (&initial_node_);
+    }
+    else if (! node_pool_.empty ())  {
+        XMLTreeNodes    *const  node = node_pool_.back ();
+
+        node_pool_.pop_back ();
+        node->recycle (name, attr_size);
+        return (node);
+    }
+
+    return (new XMLTreeNodes (name, attr_size, attr_vector_));
+}
+
+// ----------------------------------------------------------------------------
+
+// Transcodes str into buffer the way XMLTreeNodes and XMLNVPair do it, and
+// counts only that as transcoding time
+//
+const char *XMLParser::
+transcode_ (const XMLCh *const str, std::string &buffer) throw ()  {
+
+    const   XMLParseStats::counter_type start_ns = XMLParseStats::now_ns ();
+    XMLString::size_type                len = 0;
+    const   bool                        is_ascii =
+        XMLString::ascii_len (str, len);
+
+    if (! is_ascii)
+        len = XMLString::charstar_len (str);
+
+    buffer.resize (len);
+    if (is_ascii)
+        XMLString::narrow_ascii (str, &(buffer [0]), len);
+    else
+        XERCES_CPP_NAMESPACE::XMLString::transcode (str, &(buffer [0]), len);
+
+    transcoding_ns_ += XMLParseStats::now_ns () - start_ns;
+    return (buffer.c_str ());
+}
+
+// ----------------------------------------------------------------------------
+
 void XMLParser::
 startElement (const XMLCh *const name, AttributeList &attr) throw ()  {
 
@@ -139,19 +304,58 @@ startElement (const XMLCh *const name, AttributeList &attr) throw ()  {
     const   size_type   attr_size = attr.getLength ();
     XMLTreeNodes    *pt_ptr = NULL;
 
-    if (! started_)  {
-        started_ = true;
-        initial_node_.set_name (name);
-        initial_node_.set_attr_size (attr_size);
-        pt_ptr = &initial_node_;
+#ifdef XMLPARSER_STATS
+    typedef XMLParseStats::counter_type counter_type;
+
+    const   counter_type    start_ns = stats_ ? XMLParseStats::now_ns () : 0;
+    const   counter_type    pool_size = node_pool_.size ();
+    const   counter_type    spares = attr_pool_.size ();
+    const   counter_type    attr_capacity = attr_vector_.capacity ();
+#endif // XMLPARSER_STATS
+
+#ifdef XMLPARSER_STATS
+    if (stats_)  {
+        pt_ptr = new_node_ (transcode_ (name, name_buffer_), attr_size);
+        for (size_type idx = 0; idx < attr_size; ++idx)  {
+            transcode_ (attr.getName (idx), name_buffer_);
+            pt_ptr->add_attr (name_buffer_.c_str (),
+                              transcode_ (attr.getValue (idx), value_buffer_),
+                              attr_pool_);
+        }
     }
     else
-        pt_ptr = new XMLTreeNodes (name, attr_size, attr_vector_);
+#endif // XMLPARSER_STATS
+    {
+        pt_ptr = new_node_ (name, attr_size);
+
+       // Set all the attributes for this node.
+       //
+        for (size_type idx = 0; idx < attr_size; ++idx)
+            pt_ptr->add_attr (attr.getName (idx), attr.getValue (idx),
+                              attr_pool_);
+    }
 
-   // Set all the attributes for this node.
-   //
-    for (size_type idx = 0; idx < attr_size; ++idx)
-        pt_ptr->add_attr (attr.getName (idx), attr.getValue (idx));
+#ifdef XMLPARSER_STATS
+    if (stats_)  {
+        stats_->elements += 1;
+        stats_->attributes += attr_size;
+        if (astack_.size () + 1 > stats_->max_depth)
+            stats_->max_depth = astack_.size () + 1;
+
+        if (pt_ptr != &initial_node_ && pool_size == 0)
+            stats_->tree_bytes_allocated +=
+                sizeof (XMLTreeNodes) + ::strlen (pt_ptr->get_name ()) + 1;
+        if (attr_vector_.capacity () != attr_capacity)
+            stats_->tree_bytes_allocated +=
+                (attr_vector_.capacity () - attr_capacity) *
+                sizeof (XMLNVPair);
+        if (attr_size > spares)
+            for (XMLTreeNodes::attr_const_iterator itr =
+                     pt_ptr->attr_begin () + spares;
+                 itr != pt_ptr->attr_end (); ++itr)
+                stats_->tree_bytes_allocated += itr->heap_bytes ();
+    }
+#endif // XMLPARSER_STATS
 
     //
     // At this point there are only 3 possible events that may have
@@ -183,12 +387,17 @@ startElement (const XMLCh *const name, AttributeList &attr) throw ()  {
     just_opened_element_ = pt_ptr;
     just_closed_element_ = NULL;
 
+#ifdef XMLPARSER_STATS
+    if (stats_)
+        handler_ns_ += XMLParseStats::now_ns () - start_ns;
+#endif // XMLPARSER_STATS
+
     return;
 }
 
 // ----------------------------------------------------------------------------
 
-void XMLParser::endElement (const XMLCh *const name)  {
+void XMLParser::endElement (const XMLCh *const)  {
 
 //    std::cout << "--> XMLParser::endElement for "
 //                  << XMLString::to_stdstring(name);
@@ -244,18 +453,62 @@ void XMLParser::endElement (const XMLCh *const name)  {
 
 // ----------------------------------------------------------------------------
 
-void XMLParser::warning (const SAXParseException &e) throw ()  {
+// Called by the parse methods before handing the document to Xerces.
+// It returns the start time of the parse, if statistics are collected.
+//
+XMLParseStats::counter_type XMLParser::start_stats_ () throw ()  {
+
+    my_parser_strap_.mem_manager->reset ();
+    input_stall_ns_ = 0;
+
+#ifdef XMLPARSER_STATS
+    if (stats_)  {
+        handler_ns_ = 0;
+        transcoding_ns_ = 0;
+        return (XMLParseStats::now_ns ());
+    }
+#endif // XMLPARSER_STATS
+
+    return (0);
+}
+
+// ----------------------------------------------------------------------------
 
-    DMScu_FixedSizeString<1023> err;
+// Called by the parse methods after Xerces is done with the document.
+// Whatever time was not spent in our handlers, was spent in Xerces.
+//
+void XMLParser::end_stats_ (XMLParseStats::counter_type start_ns,
+                            XMLParseStats::counter_type bytes_consumed)
+    throw ()  {
+
+    static_cast<void>(start_ns);
+    static_cast<void>(bytes_consumed);
+
+#ifdef XMLPARSER_STATS
+    if (stats_)  {
+        const   XMLParseStats::counter_type total_ns =
+            XMLParseStats::now_ns () - start_ns;
+
+        stats_->documents += 1;
+        stats_->bytes_consumed += bytes_consumed;
+        stats_->total_ns += total_ns;
+        stats_->xerces_ns += total_ns - handler_ns_ - input_stall_ns_;
+        stats_->tree_building_ns += handler_ns_ - transcoding_ns_;
+        stats_->transcoding_ns += transcoding_ns_;
+        stats_->input_stall_ns += input_stall_ns_;
+        stats_->xerces_bytes_allocated +=
+            my_parser_strap_.mem_manager->bytes_allocated ();
+    }
+#endif // XMLPARSER_STATS
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
 
-    err.printf ("WARNING: (System ID: %s) -- line: %d, char: %d\n"
-                "         Message: '%s'",
-                XMLString::to_stdstring (e.getSystemId ()).c_str (),
-                e.getLineNumber (),
-                e.getColumnNumber (),
-                XMLString::to_stdstring (e.getMessage ()).c_str ());
+void XMLParser::warning (const SAXParseException &e) throw ()  {
 
-    warning_msgs_.push_back (err.c_str ());
+    warning_msgs_.push_back (XMLparse_error_text ("WARNING", e));
     return;
 }
 
@@ -264,55 +517,247 @@ void XMLParser::warning (const SAXParseException &e) throw ()  {
 void XMLParser::error (const SAXParseException &e) throw ()  {
 
     has_problem_ = true;
+    error_msgs_.push_back (XMLparse_error_text ("WARNING", e));
+    return;
+}
 
-    DMScu_FixedSizeString<1023> err;
+// ----------------------------------------------------------------------------
 
-    err.printf ("WARNING: (System ID: %s) -- line: %d, char: %d\n"
-                "         Message: '%s'",
-                XMLString::to_stdstring (e.getSystemId ()).c_str (),
-                e.getLineNumber (),
-                e.getColumnNumber (),
-                XMLString::to_stdstring (e.getMessage ()).c_str ());
+void XMLParser::fatalError (const SAXParseException &e) throw ()  {
 
-    error_msgs_.push_back (err.c_str ());
+    has_problem_ = true;
+    fatal_error_ = XMLparse_error_text ("FATAL ERROR", e);
     return;
 }
 
 // ----------------------------------------------------------------------------
 
-void XMLParser::fatalError (const SAXParseException &e) throw ()  {
+XMLParser::InputSource *XMLParser::
+resolveEntity (const XMLCh *const, const XMLCh *const system_id)  {
 
-    has_problem_ = true;
+    typedef XERCES_CPP_NAMESPACE::MemBufInputSource XmlBuffer;
+
+    if (system_id == NULL)
+        return (NULL);
+
+    const   std::string sys_id = XMLString::to_stdstring (system_id);
+    const   std::string *content = NULL;
+
+    {
+        const   std::lock_guard<std::mutex> guard (local_entities_mutex_);
+        const   EntityMap::const_iterator   citer =
+            local_entities_.find (sys_id);
+
+        if (citer == local_entities_.end ())
+            return (NULL);  // Let Xerces resolve it the default way
+        content = citer->second;
+    }
+
+   // Contents are never freed, so the content outlives the source.
+   // Xerces adopts the returned input source.
+   //
+    XmlBuffer   *const  mem_buf =
+        new XmlBuffer (reinterpret_cast<const XMLByte *>(content->data ()),
+                       content->size (),
+                       system_id,
+                       false);  // Don't adopt the input buffer
+
+    mem_buf->setCopyBufToStream (false);
+    return (mem_buf);
+}
+
+// ----------------------------------------------------------------------------
+
+// Class static
+//
+const std::string &XMLParser::
+read_local_entity_ (const char *const sys_id, const char *const file)  {
+
+    std::ifstream   in_file (file, std::ios::in | std::ios::binary);
+
+    if (! in_file)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLParser::register_local_entity(): "
+                    "Cannot open file '%s' for system id '%s'",
+                    file, sys_id);
+
+        throw std::runtime_error (err.c_str ());
+    }
+
+    std::ostringstream  content;
+
+    content << in_file.rdbuf ();
+
+    const   std::lock_guard<std::mutex> guard (local_entities_mutex_);
+
+    local_contents_.push_back (content.str ());
+    local_entities_ [sys_id] = &(local_contents_.back ());
+    return (local_contents_.back ());
+}
+
+// ----------------------------------------------------------------------------
+
+// Class static
+//
+void XMLParser::register_local_entity (const char *const system_id,
+                                       const char *const local_file)  {
+
+    read_local_entity_ (system_id, local_file);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Class static
+//
+bool XMLParser::preload_grammar (const char *const system_id,
+                                 const char *const local_file,
+                                 GrammarType grammar_type)  {
+
+    typedef XERCES_CPP_NAMESPACE::MemBufInputSource XmlBuffer;
+
+    const   std::string &content = read_local_entity_ (system_id, local_file);
+    XmlBuffer           mem_buf (
+        reinterpret_cast<const XMLByte *>(content.data ()),
+        content.size (),
+        system_id,
+        false);  // Don't adopt the input buffer
+
+    mem_buf.setCopyBufToStream (false);
+
+    try  {
+        SAXParser   parser (
+            NULL,
+            XERCES_CPP_NAMESPACE::XMLPlatformUtils::fgMemoryManager,
+            grammar_pool_);
+
+        return (parser.loadGrammar (mem_buf, grammar_type, true) != NULL);
+    }
+    catch (const XERCES_CPP_NAMESPACE::XMLException &ex)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLParser::preload_grammar(): "
+                    "ERROR while loading grammar '%s'. Message: '%s'\n",
+                    system_id,
+                    XMLString::to_stdstring (ex.getMessage ()).c_str ());
+
+        throw std::runtime_error (err.c_str ());
+    }
+    catch (const XERCES_CPP_NAMESPACE::SAXException &ex)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLParser::preload_grammar(): "
+                    "ERROR while loading grammar '%s'. Message: '%s'\n",
+                    system_id,
+                    XMLString::to_stdstring (ex.getMessage ()).c_str ());
+
+        throw std::runtime_error (err.c_str ());
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// Class static
+//
+void XMLParser::lock_grammar_pool ()  {
+
+    grammar_pool_->lockPool ();
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Detaches all the nodes below the initial node and moves them to the
+// node pool, in reverse document (pre-order) order.
+//
+void XMLParser::recycle_tree_ ()  {
+
+    const   std::vector<XMLTreeNodes *>::size_type  pool_size =
+        node_pool_.size ();
+    XMLTreeNodes                                    *node =
+        initial_node_.get_child ();
+
+    initial_node_.set_child (NULL);
+    initial_node_.set_sibling (NULL);
+
+   // Pre-order walk over the child/sibling links. The (empty) element
+   // stack is borrowed to hold the pending siblings.
+   //
+    while (node != NULL)  {
+        XMLTreeNodes    *const  child = node->get_child ();
+        XMLTreeNodes    *const  sibling = node->get_sibling ();
+
+        node->set_child (NULL);
+        node->set_sibling (NULL);
+        node_pool_.push_back (node);
+
+        if (sibling != NULL)
+            astack_.push (sibling);
+
+        if (child != NULL)
+            node = child;
+        else if (! astack_.empty ())  {
+            node = astack_.top ();
+            astack_.pop ();
+        }
+        else
+            node = NULL;
+    }
+
+    std::reverse (node_pool_.begin () + pool_size, node_pool_.end ());
+    return;
+}
+
+// ----------------------------------------------------------------------------
 
-    DMScu_FixedSizeString<1023> err;
+void XMLParser::reset ()  {
 
-    err.printf ("FATAL ERROR: (System ID: %s) -- line: %d, char: %d\n"
-                "         Message: '%s'",
-                XMLString::to_stdstring (e.getSystemId ()).c_str (),
-                e.getLineNumber (),
-                e.getColumnNumber (),
-                XMLString::to_stdstring (e.getMessage ()).c_str ());
+    while (! astack_.empty ())
+        astack_.pop ();
+
+    recycle_tree_ ();
+
+   // Move the attribute buffers to the spare pool, also in reverse order.
+   //
+    const   XMLTreeNodes::attr_vector::size_type    attr_size =
+        attr_vector_.size ();
+    const   XMLTreeNodes::attr_vector::size_type    pool_size =
+        attr_pool_.size ();
+
+    attr_pool_.resize (pool_size + attr_size);
+    for (XMLTreeNodes::attr_vector::size_type i = 0; i < attr_size; ++i)
+        attr_pool_ [pool_size + i].swap (attr_vector_ [attr_size - i - 1]);
+    attr_vector_.clear ();
+
+    has_problem_ = false;
+    started_ = false;
+    just_closed_element_ = NULL;
+    just_opened_element_ = NULL;
+    warning_msgs_.clear ();
+    error_msgs_.clear ();
+    fatal_error_.clear ();
 
-    fatal_error_ = err.c_str ();
     return;
 }
 
 // ----------------------------------------------------------------------------
 
 bool XMLParser::parse_string (const char *const xml,
-                                  size_type xml_len,
+                                  std::size_t xml_len,
                                   const char *const sys_id)  {
 
-    typedef XERCES_CPP_NAMESPACE::MemBufInputSource XmlBuffer;
+    if (started_)
+        reset ();
 
-    const   XmlBuffer   mem_buf (reinterpret_cast<const XMLByte *const>(xml),
-                                 xml_len,
-                                 sys_id,
-                                 false);  // Don't adopt the input buffer
+    mem_buf_->reset (xml, xml_len, sys_id);
 
     try   {
-        my_parser_strap_.parser->parse (mem_buf);
+        const   XMLParseStats::counter_type start_ns = start_stats_ ();
+
+        my_parser_strap_.parser->parse (*mem_buf_);
         // my_parser_strap_.parser->parse (xml);
+        end_stats_ (start_ns, xml_len);
     }
     catch (const XERCES_CPP_NAMESPACE::SAXException &ex)  {
         DMScu_FixedSizeString<1023> err;
@@ -344,10 +789,54 @@ bool XMLParser::parse_string (const char *const xml,
 
 // ----------------------------------------------------------------------------
 
+// The file is opened once and parsed from its fd, so a named pipe is never
+// closed and opened again, and no data is lost in between. Compression is
+// told by the first bytes that are read (see XMLmake_decompress_reader()),
+// which works for pipes too.
+//
 bool XMLParser::parse_file (const char *const filename)  {
 
+    const   int fd = ::open (filename, O_RDONLY);
+
+    if (fd >= 0)  {
+        const   bool    read_ahead =
+            threaded_input_ || file_input_ == fi_read_ahead;
+        struct  stat    fd_stat;
+
+       // Only regular files take posix_fadvise() hints
+       //
+        const   bool    regular =
+            ::fstat (fd, &fd_stat) == 0 && S_ISREG (fd_stat.st_mode);
+
+        try  {
+            const   bool    ret =
+                parse_callback (
+                    make_fd_reader_ (fd,
+                                     read_ahead && regular
+                                         ? read_ahead_size_ : 0,
+                                     read_ahead),
+                    filename);
+
+            ::close (fd);
+            return (ret);
+        }
+        catch (...)  {
+            ::close (fd);
+            throw;
+        }
+    }
+
+    if (started_)
+        reset ();
+
+   // Only files we could not open (e.g. URLs) get here with statistics
+   // on. Their size is unknown.
+   //
     try  {
+        const   XMLParseStats::counter_type start_ns = start_stats_ ();
+
         my_parser_strap_.parser->parse (filename);
+        end_stats_ (start_ns, 0);
     }
     catch (const XERCES_CPP_NAMESPACE::SAXException &ex)  {
         DMScu_FixedSizeString<1023> err;
@@ -379,6 +868,108 @@ bool XMLParser::parse_file (const char *const filename)  {
 
 // ----------------------------------------------------------------------------
 
+bool XMLParser::parse_callback (const XMLReadCallback &read_cb,
+                                const char *const sys_id)  {
+
+    if (started_)
+        reset ();
+
+    XMLCallbackInputSource  source (read_cb, sys_id,
+                                    my_parser_strap_.mem_manager);
+
+    try  {
+        const   XMLParseStats::counter_type start_ns = start_stats_ ();
+
+        my_parser_strap_.parser->parse (source);
+        end_stats_ (start_ns, source.bytes_read ());
+    }
+    catch (const XERCES_CPP_NAMESPACE::SAXException &ex)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLParser::parse_callback(): SAX exception thrown. "
+                    "Message: '%s'\n",
+                    XMLString::to_stdstring (ex.getMessage ()).c_str ());
+
+        has_problem_ = true;
+        throw std::runtime_error (err.c_str ());
+    }
+    catch (const std::exception &ex)  {
+        has_problem_ = true;
+        throw;
+    }
+    catch (...)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLParser::parse_callback(): An unknown exception was "
+                    "thrown during parsing.\n"
+                    "No further information is available.");
+
+        has_problem_ = true;
+        throw std::runtime_error (err.c_str ());
+    }
+
+    return (! has_problem_);
+}
+
+// ----------------------------------------------------------------------------
+
+void XMLParser::set_file_input (FileInput strategy, std::size_t buffer_size)  {
+
+    file_input_ = strategy;
+    read_ahead_size_ = buffer_size > 0 ? buffer_size : 1;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+XMLReadCallback XMLParser::
+make_reader_ (const XMLReadCallback &raw_cb,
+              bool read_ahead,
+              const std::shared_ptr<XMLReadCanceller> &canceller)  {
+
+    if (read_ahead)
+        return (XMLmake_prefetch_reader (XMLmake_decompress_reader (raw_cb),
+                                         read_ahead_size_,
+                                         &input_stall_ns_,
+                                         canceller));
+    return (XMLmake_decompress_reader (raw_cb));
+}
+
+// ----------------------------------------------------------------------------
+
+XMLReadCallback XMLParser::
+make_fd_reader_ (int fd, std::size_t will_need, bool read_ahead)  {
+
+    if (read_ahead)  {
+        const   std::shared_ptr<XMLReadCanceller>   canceller =
+            std::make_shared<XMLReadCanceller> ();
+
+        return (make_reader_ (XMLmake_fd_reader (fd, will_need, canceller),
+                              true,
+                              canceller));
+    }
+    return (make_reader_ (XMLmake_fd_reader (fd, will_need), false));
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLParser::parse_stream (std::istream &is, const char *const sys_id)  {
+
+    return (parse_callback (make_reader_ (XMLmake_stream_reader (is),
+                                          threaded_input_),
+                            sys_id));
+}
+
+// ----------------------------------------------------------------------------
+
+bool XMLParser::parse_fd (int fd, const char *const sys_id)  {
+
+    return (parse_callback (make_fd_reader_ (fd, 0, threaded_input_),
+                            sys_id));
+}
+
+// ----------------------------------------------------------------------------
+
 std::ostream &XMLParser::dumpForm (std::ostream &os) const  {
 
     return (initial_node_.dump_xml (os) << std::endl);
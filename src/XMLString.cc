@@ -96,6 +96,138 @@ void XMLString::swap (XMLString &rhs) throw ()  {
 
 // ----------------------------------------------------------------------------
 
+// Decodes the reference that starts at the '&' in src. If it is well formed,
+// the decoded bytes are written to dst and the length of the reference is
+// returned. Otherwise, it returns 0.
+//
+static inline XMLString::size_type
+decode_one_reference (const char *src, const char *const end, char *&dst)  {
+
+    const   XMLString::size_type    avail = end - src;
+    const   char                    *const  semi = static_cast<const char *>
+        (::memchr (src, ';', avail < 12 ? avail : 12));
+
+    if (semi == NULL)
+        return (0);
+
+    const   XMLString::size_type    ref_len = semi - src + 1;
+
+    if (src [1] != '#')  {
+        char    c = 0;
+
+        switch (ref_len)  {
+            case 4:
+                if (src [2] == 't')
+                    c = src [1] == 'l' ? '<' : src [1] == 'g' ? '>' : 0;
+                break;
+            case 5:
+                if (! ::memcmp (src + 1, "amp", 3))
+                    c = '&';
+                break;
+            case 6:
+                if (! ::memcmp (src + 1, "quot", 4))
+                    c = '"';
+                else if (! ::memcmp (src + 1, "apos", 4))
+                    c = '\'';
+                break;
+        }
+        if (c == 0)
+            return (0);
+
+        *dst++ = c;
+        return (ref_len);
+    }
+
+   // Character reference
+   //
+    const   bool    hex = src [2] == 'x';
+    const   char    *iter = src + (hex ? 3 : 2);
+    unsigned long   cp = 0;
+
+    if (iter == semi)
+        return (0);
+    for ( ; iter != semi; ++iter)  {
+        const   char    c = *iter;
+
+        if (c >= '0' && c <= '9')
+            cp = cp * (hex ? 16 : 10) + (c - '0');
+        else if (hex && c >= 'a' && c <= 'f')
+            cp = cp * 16 + (c - 'a' + 10);
+        else if (hex && c >= 'A' && c <= 'F')
+            cp = cp * 16 + (c - 'A' + 10);
+        else
+            return (0);
+    }
+    if (cp == 0 || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+        return (0);
+
+    if (cp < 0x80)
+        *dst++ = char (cp);
+    else if (cp < 0x800)  {
+        *dst++ = char (0xC0 | (cp >> 6));
+        *dst++ = char (0x80 | (cp & 0x3F));
+    }
+    else if (cp < 0x10000)  {
+        *dst++ = char (0xE0 | (cp >> 12));
+        *dst++ = char (0x80 | ((cp >> 6) & 0x3F));
+        *dst++ = char (0x80 | (cp & 0x3F));
+    }
+    else  {
+        *dst++ = char (0xF0 | (cp >> 18));
+        *dst++ = char (0x80 | ((cp >> 12) & 0x3F));
+        *dst++ = char (0x80 | ((cp >> 6) & 0x3F));
+        *dst++ = char (0x80 | (cp & 0x3F));
+    }
+
+    return (ref_len);
+}
+
+// ----------------------------------------------------------------------------
+
+// class-static
+//
+// The spans between references are found with memchr(), which is
+// vectorized in any decent C library, and moved in bulk. Nothing is moved
+// until the first reference, and a decoded reference is never longer than
+// the reference itself, so it all works in place.
+//
+XMLString::size_type
+XMLString::decode_references (char *const str, size_type len)  {
+
+    const   char    *const  end = str + len;
+    const   char    *src = static_cast<const char *>(::memchr (str, '&', len));
+
+    if (src == NULL)  {
+        str [len] = 0;
+        return (len);
+    }
+
+    char    *dst = const_cast<char *>(src);
+
+    while (src != end)  {
+        const   size_type   ref_len = decode_one_reference (src, end, dst);
+
+        if (ref_len == 0)
+            *dst++ = *src++;  // Not a reference; keep the '&'
+        else
+            src += ref_len;
+
+        const   char    *const  next_amp =
+            static_cast<const char *>(::memchr (src, '&', end - src));
+        const   char    *const  span_end = next_amp ? next_amp : end;
+
+        if (dst != src)
+            ::memmove (dst, src, span_end - src);
+        dst += span_end - src;
+        src = span_end;
+    }
+
+    *dst = 0;
+    return (dst - str);
+}
+
+// ----------------------------------------------------------------------------
+
 static std::string
 hokey_transcode (const XMLString &input_string) throw ()  {
 
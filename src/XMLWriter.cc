@@ -9,6 +9,7 @@
 #include <stdexcept>
 #include <sstream>
 
+#include <XMLEscape.h>
 #include <XMLWriter.h>
 
 // ----------------------------------------------------------------------------
@@ -30,7 +31,7 @@ void XMLWriter::Element::write_open_tag ()  {
         }
 
         write ("<");
-        write (name_.c_str ());
+        write (get_name ());
     }
     else
         throw std::runtime_error ("XMLWriter::Element::write_open_tag(): "
@@ -55,7 +56,7 @@ void XMLWriter::Element::write_close_tag ()  {
         assert (indentation_level > 0);
         indent (indentation_level - 1);
         write ("</");
-        write (name_.c_str ());
+        write (get_name ());
         write (">");
     }
     else
@@ -76,10 +77,8 @@ write_attribute(const char *name, const char *the_value, bool encode_content) {
         write ("=\"");
 
         if (encode_content)  {
-            std::string value_as_literal;
-
-            encode_literal (the_value, value_as_literal);
-            write (value_as_literal.c_str ());
+            encode_literal (the_value, writer_->literal_);
+            write (writer_->literal_.c_str ());
         }
         else
             write (the_value);
@@ -177,73 +176,29 @@ encode_literal (const char *const input, std::string &output) throw ()  {
     // INPUT: an XML string (that is, the XML subset of the Unicode character
     //        set) -- encoded as UTF-8.
     //
-    // OUTPUT: an XML string (that is, the XML subset of the Unicode character
-    //         set) -- encoded as a XMLString, whatever _that_ encoding
-    //         that happens to imply.
+    // OUTPUT: the same, as UTF-8. Valid multibyte sequences are copied as
+    //         they are. A byte that doesn't belong to one is taken to be
+    //         Latin-1 and becomes a character reference.
     //
-    // The thing is, this routine really isn't doing it right at the moment.
-    // In particular, we have no real "UTF-8 <--> UTF-16" converter at present.
-    // We'll cross that bridge when we come to it.  Right now the best I can do
-    // is to read in the input string as a plain old byte stream and examine it
-    // byte by byte; in other words, I'm assuming a trivial UTF-8 subset which
-    // never escapes into multicharacter representations.  I assume that the
-    // output string is the same way.  I'm also assuming that the OS uses some
-    // superset of ASCII for its characters.
-
-    std::string out_stream;
-
-    out_stream.reserve (strlen (input));
-    for (const char *iter = input; *iter != 0; ++iter)  {
-        typedef unsigned char   unsigned_char;
-
-        const   int the_char_as_int = unsigned_char (*iter);
-
-        if (! ::isprint (the_char_as_int))  {
-            char   buffer [16];
-
-            ::sprintf (buffer, "%d", the_char_as_int);
-            out_stream += "&#";
-            out_stream += buffer;
-            out_stream += ';';
-        }
-        else  {
-            switch (*iter)  {
-                case '<':
-                    out_stream += "&lt;";
-                    break;
-
-                case '&':
-                    out_stream += "&amp;";
-                    break;
-
-                case '>':
-                    out_stream += "&gt;";
-                    break;
+    // The work is done by XMLencode_literal(), which appends to output
+    // directly, without a temporary string and without sprintf().
 
-                case '\'':
-                    out_stream += "&apos;";
-                    break;
+    const   std::string::size_type  len = ::strlen (input);
 
-                case '\"':
-                    out_stream += "&quot;";
-                    break;
+    if (input >= output.data () && input < output.data () + output.size ()) {
+        std::string tmp;
 
-               // implementation detail -- gotta do this because the internal
-               // stream deals with the NULL character in a peculiar way.
-               // Sorry.
-               //
-                case '\0':
-                    out_stream += "&#0;";
-                    break;
-
-                default:
-                    out_stream += *iter;
-                    break;
-            }
-        }
+        encode_literal (input, tmp);
+        output.swap (tmp);
+        return;
     }
 
-    output = out_stream;
+    output.clear ();
+    output.reserve (len + len / 8);
+    XMLencode_literal (input, len,
+                       [&output] (const char *run, std::size_t run_len)  {
+                           output.append (run, run_len);
+                       });
     return;
 }
 
@@ -275,6 +230,7 @@ void XMLWriter::write_close_tag ()  {
 
     e->write_close_tag ();
 
+    names_.resize (e->name_offset ());
     stack_.pop_back ();
     return;
 }
@@ -326,7 +282,20 @@ void XMLWriter::write_cdata (const char *cdata)  {
 
 void XMLWriter::write_comment (const char *const comment)  {
 
-    XMLWriter::Element  *const  e = get_current_element ();
+    std::string encoded_comment;
+
+    encode_comment (comment, encoded_comment);
+    indent ();
+    write (encoded_comment.c_str ());
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// class-static
+//
+void XMLWriter::encode_comment (const char *const comment,
+                                std::string &encoded_comment)  {
 
     // Honestly, I'm not sure where one can and cannot write a comment in XML.
     // The XML 1.0 standard ("Extensible Markup Language (XML) 1.0 (Second
@@ -432,10 +401,9 @@ void XMLWriter::write_comment (const char *const comment)  {
             encoded_strm << escape_code << trailing_hyphen_indicator;
     }
 
-    encoded_strm << "-->" << std::ends;
+    encoded_strm << "-->";
 
-    indent ();
-    write (encoded_strm.str ().c_str ());
+    encoded_comment = encoded_strm.str ();
     return;
 }
 
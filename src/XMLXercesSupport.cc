@@ -0,0 +1,69 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <stdexcept>
+
+#include <DMScu_FixedSizeString.h>
+
+#include <XMLString.h>
+#include <XMLXercesSupport.h>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+XMLXercesInitializer::XMLXercesInitializer ()  {
+
+    try  {
+        XERCES_CPP_NAMESPACE::XMLPlatformUtils::Initialize ();
+    }
+    catch (const XERCES_CPP_NAMESPACE::XMLException &ex)  {
+        DMScu_FixedSizeString<1023> err;
+
+        err.printf ("XMLXercesInitializer::XMLXercesInitializer(): "
+                    "ERROR during XML utilities initialization. "
+                    "Message: '%s'\n",
+                    XMLString::to_stdstring (ex.getMessage ()).c_str ());
+
+        throw std::runtime_error (err.c_str ());
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+XMLXercesInitializer::~XMLXercesInitializer () throw ()  {
+
+    XERCES_CPP_NAMESPACE::XMLPlatformUtils::Terminate ();
+}
+
+// ----------------------------------------------------------------------------
+
+std::string
+XMLparse_error_text (const char *severity,
+                     const XERCES_CPP_NAMESPACE::SAXParseException &e)  {
+
+    DMScu_FixedSizeString<1023> err;
+
+    err.printf ("%s: (System ID: %s) -- line: %d, char: %d\n"
+                "         Message: '%s'",
+                severity,
+                XMLString::to_stdstring (e.getSystemId ()).c_str (),
+                e.getLineNumber (),
+                e.getColumnNumber (),
+                XMLString::to_stdstring (e.getMessage ()).c_str ());
+
+    return (err.c_str ());
+}
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
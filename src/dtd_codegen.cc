@@ -0,0 +1,1002 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+// This reads a DTD and writes a C++ header that binds the grammar to
+// structs. For every declared element, the header has:
+//
+//   - A struct with a data member per attribute and per child element. A
+//     child element that may occur more than once is a std::vector. One
+//     that may be left out (e.g. NODE? or a branch of a choice) is a
+//     std::optional.
+//   - Its XMLBinding specialization, so XMLBinder parses documents straight
+//     into the structs (see XMLBinder.h).
+//   - An XMLwrite() function that writes the struct out through an
+//     XMLWriter. It writes only the children and attributes that are
+//     present.
+//
+// Attributes are std::string, unless their type is given with -t. An
+// #IMPLIED attribute of another type is a std::optional. An empty string
+// attribute that is not #REQUIRED is taken as absent.
+//
+// Binding in strict mode validates the structure as it parses. It rejects
+// elements and attributes that the DTD doesn't declare where they occur, a
+// second occurrence of a child that may occur only once, and a value of an
+// enumerated attribute that is not in its enumeration. When an element
+// ends, it checks that its #REQUIRED attributes are there, and the children
+// it can't go without (NODE and NODE+, outside of a choice). It doesn't
+// check the order of the children or which branch of a choice is taken,
+// and it doesn't fill in default attribute values. Xerces does all of that,
+// if the documents are bound with validation on and a DOCTYPE that refers
+// to the DTD.
+//
+// Not supported: parameter entities, and binding of character data
+// (#PCDATA is parsed over). Elements declared ANY get no child members.
+//
+
+// ----------------------------------------------------------------------------
+
+static void usage ()  {
+
+    std::cout << "\nUsage:\n"
+                 "    dtd_codegen [options] <DTD file>\n\n"
+                 "Options:\n"
+                 "    -o=file           Write the header to file. "
+                 "Defaults to stdout.\n"
+                 "    -n=namespace      Namespace of the structs. "
+                 "Defaults to xmlgen.\n"
+                 "    -t=ELEM@ATTR=type C++ type of an attribute. type is "
+                 "one of\n"
+                 "                      string*, int, unsigned, long, "
+                 "double, bool,\n"
+                 "                      timestamp. It may be repeated.\n\n"
+                 "  * = Default if not provided explicitly\n"
+              << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+
+struct  DtdAttribute  {
+
+    std::string name;
+    std::string type;      // As declared, e.g. CDATA or (A | B)
+    std::string presence;  // #REQUIRED, #IMPLIED, #FIXED or the default
+    std::string cpp_type;
+    bool        optional = false;  // A std::optional of cpp_type
+    std::string member;
+
+    std::vector<std::string>    values;  // Of an enumerated type
+};
+
+struct  DtdChild  {
+
+    std::string name;
+    bool        repeated = false;  // May occur more than once
+    bool        optional = false;  // May be left out
+    std::string member;
+};
+
+struct  DtdElement  {
+
+    std::string                 name;
+    std::string                 content;  // As declared
+    bool                        declared = false;
+    bool                        any = false;
+    bool                        text = false;
+    std::vector<DtdChild>       children;
+    std::vector<DtdAttribute>   attributes;
+    std::string                 cpp_name;
+};
+
+typedef std::map<std::string, DtdElement>   ElementMap;
+
+// ----------------------------------------------------------------------------
+
+// A recursive descent reader of the markup declarations of a DTD
+//
+class   DtdReader  {
+
+    public:
+
+        DtdReader (const std::string &text, ElementMap &elements)
+            : text_ (text), pos_ (0), elements_ (elements)  {   }
+
+        void read (std::vector<std::string> &order);
+
+    private:
+
+        const   std::string &text_;
+        std::size_t         pos_;
+        ElementMap          &elements_;
+
+        typedef std::vector<DtdChild>   ChildList;
+
+        void fail_ (const char *what) const;
+        void skip_space_ ();
+        bool skip_past_ (const char *end);
+        bool looking_at_ (const char *str);
+        void expect_ (char c);
+        std::string name_ ();
+        std::string quoted_ ();
+        std::string until_closing_ ();
+
+        void read_element_ (std::vector<std::string> &order);
+        void read_attlist_ ();
+        void read_group_ (DtdElement &element, ChildList &children);
+};
+
+// ----------------------------------------------------------------------------
+
+void DtdReader::fail_ (const char *what) const  {
+
+    std::size_t line = 1;
+
+    for (std::size_t i = 0; i < pos_ && i < text_.size (); ++i)
+        line += text_ [i] == '\n';
+
+    std::ostringstream  err;
+
+    err << "DTD error at line " << line << ": " << what;
+    throw std::runtime_error (err.str ());
+}
+
+// ----------------------------------------------------------------------------
+
+void DtdReader::skip_space_ ()  {
+
+    while (pos_ < text_.size () &&
+           std::isspace (static_cast<unsigned char>(text_ [pos_])))
+        ++pos_;
+    if (pos_ < text_.size () && text_ [pos_] == '%')
+        fail_ ("parameter entity references are not supported");
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DtdReader::skip_past_ (const char *end)  {
+
+    const   std::size_t found = text_.find (end, pos_);
+
+    if (found == std::string::npos)
+        return (false);
+    pos_ = found + ::strlen (end);
+    return (true);
+}
+
+// ----------------------------------------------------------------------------
+
+bool DtdReader::looking_at_ (const char *str)  {
+
+    const   std::size_t len = ::strlen (str);
+
+    if (text_.compare (pos_, len, str) != 0)
+        return (false);
+    pos_ += len;
+    return (true);
+}
+
+// ----------------------------------------------------------------------------
+
+void DtdReader::expect_ (char c)  {
+
+    skip_space_ ();
+    if (pos_ >= text_.size () || text_ [pos_] != c)
+        fail_ ((std::string ("'") + c + "' expected").c_str ());
+    ++pos_;
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+std::string DtdReader::name_ ()  {
+
+    skip_space_ ();
+
+    const   std::size_t start = pos_;
+
+    while (pos_ < text_.size ())  {
+        const   unsigned char   c = text_ [pos_];
+
+        if (std::isalnum (c) || c == '_' || c == ':' || c == '.' ||
+            c == '-' || c == '#' || c >= 0x80)
+            ++pos_;
+        else
+            break;
+    }
+    if (pos_ == start)
+        fail_ ("name expected");
+
+    return (text_.substr (start, pos_ - start));
+}
+
+// ----------------------------------------------------------------------------
+
+std::string DtdReader::quoted_ ()  {
+
+    skip_space_ ();
+
+    const   char    quote = pos_ < text_.size () ? text_ [pos_] : 0;
+
+    if (quote != '"' && quote != '\'')
+        fail_ ("quoted value expected");
+
+    const   std::size_t end = text_.find (quote, pos_ + 1);
+
+    if (end == std::string::npos)
+        fail_ ("unterminated quoted value");
+
+    const   std::string value = text_.substr (pos_ + 1, end - pos_ - 1);
+
+    pos_ = end + 1;
+    return (value);
+}
+
+// ----------------------------------------------------------------------------
+
+// Skips a declaration we don't use, minding the quoted values in it
+//
+std::string DtdReader::until_closing_ ()  {
+
+    const   std::size_t start = pos_;
+
+    while (pos_ < text_.size () && text_ [pos_] != '>')
+        if (text_ [pos_] == '"' || text_ [pos_] == '\'')
+            quoted_ ();
+        else
+            ++pos_;
+    if (pos_ >= text_.size ())
+        fail_ ("unterminated declaration");
+    ++pos_;
+
+    return (text_.substr (start, pos_ - start - 1));
+}
+
+// ----------------------------------------------------------------------------
+
+void DtdReader::read (std::vector<std::string> &order)  {
+
+    for (;;)  {
+        while (pos_ < text_.size () &&
+               std::isspace (static_cast<unsigned char>(text_ [pos_])))
+            ++pos_;
+        if (pos_ >= text_.size ())
+            break;
+
+        if (looking_at_ ("<!--"))  {
+            if (! skip_past_ ("-->"))
+                fail_ ("unterminated comment");
+        }
+        else if (looking_at_ ("<?"))  {
+            if (! skip_past_ ("?>"))
+                fail_ ("unterminated processing instruction");
+        }
+        else if (looking_at_ ("<!ELEMENT"))
+            read_element_ (order);
+        else if (looking_at_ ("<!ATTLIST"))
+            read_attlist_ ();
+        else if (looking_at_ ("<!ENTITY") || looking_at_ ("<!NOTATION"))
+            until_closing_ ();
+        else if (text_ [pos_] == '%')
+            fail_ ("parameter entity references are not supported");
+        else
+            fail_ ("markup declaration expected");
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+// Reads a parenthesized group of a content model, after its '(', and its
+// occurrence indicator. A child is repeated, if it occurs more than once in
+// the group or the group or the child may repeat. It is optional, if the
+// group or the child may be left out, or the group is a choice.
+//
+void DtdReader::read_group_ (DtdElement &element, ChildList &children)  {
+
+    ChildList   group;
+    std::size_t members = 0;
+    bool        choice = false;
+
+    for (;;)  {
+        members += 1;
+        skip_space_ ();
+        if (pos_ < text_.size () && text_ [pos_] == '(')  {
+            ++pos_;
+            read_group_ (element, group);
+        }
+        else  {
+            const   std::string name = name_ ();
+
+            if (name == "#PCDATA")
+                element.text = true;
+            else  {
+                DtdChild    child;
+
+                child.name = name;
+                if (pos_ < text_.size () &&
+                    (text_ [pos_] == '*' || text_ [pos_] == '+'))
+                    child.repeated = true;
+                if (pos_ < text_.size () &&
+                    (text_ [pos_] == '*' || text_ [pos_] == '?'))
+                    child.optional = true;
+                if (pos_ < text_.size () &&
+                    (text_ [pos_] == '*' || text_ [pos_] == '+' ||
+                     text_ [pos_] == '?'))
+                    ++pos_;
+                group.push_back (child);
+            }
+        }
+
+        skip_space_ ();
+        if (pos_ < text_.size () && text_ [pos_] == ')')  {
+            ++pos_;
+            break;
+        }
+        if (pos_ >= text_.size () ||
+            (text_ [pos_] != ',' && text_ [pos_] != '|'))
+            fail_ ("',', '|' or ')' expected in content model");
+        choice = choice || text_ [pos_] == '|';
+        ++pos_;
+    }
+
+    const   bool    group_repeated =
+        pos_ < text_.size () && (text_ [pos_] == '*' || text_ [pos_] == '+');
+    const   bool    group_optional =
+        (choice && members > 1) ||
+        (pos_ < text_.size () && (text_ [pos_] == '*' || text_ [pos_] == '?'));
+
+    if (pos_ < text_.size () &&
+        (text_ [pos_] == '*' || text_ [pos_] == '+' || text_ [pos_] == '?'))
+        ++pos_;
+
+    for (ChildList::const_iterator citer = group.begin ();
+         citer != group.end (); ++citer)  {
+        bool    found = false;
+
+        for (ChildList::iterator iter = children.begin ();
+             iter != children.end (); ++iter)
+            if (iter->name == citer->name)  {
+                iter->repeated = true;
+                found = true;
+            }
+        if (! found)  {
+            DtdChild    child = *citer;
+
+            child.repeated = child.repeated || group_repeated;
+            child.optional = child.optional || group_optional;
+            children.push_back (child);
+        }
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void DtdReader::read_element_ (std::vector<std::string> &order)  {
+
+    const   std::string name = name_ ();
+    DtdElement          &element = elements_ [name];
+
+    if (element.declared)
+        fail_ ("element declared twice");
+    element.name = name;
+    element.declared = true;
+    order.push_back (name);
+
+    skip_space_ ();
+
+    const   std::size_t start = pos_;
+
+    if (looking_at_ ("EMPTY"))
+        ;
+    else if (looking_at_ ("ANY"))
+        element.any = true;
+    else  {
+        expect_ ('(');
+        read_group_ (element, element.children);
+    }
+    element.content = text_.substr (start, pos_ - start);
+    expect_ ('>');
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+void DtdReader::read_attlist_ ()  {
+
+    DtdElement  &element = elements_ [name_ ()];
+
+    for (;;)  {
+        skip_space_ ();
+        if (pos_ < text_.size () && text_ [pos_] == '>')  {
+            ++pos_;
+            break;
+        }
+
+        DtdAttribute    attr;
+
+        attr.name = name_ ();
+        skip_space_ ();
+        if (pos_ < text_.size () && text_ [pos_] == '(')  {
+            const   std::size_t end = text_.find (')', pos_);
+
+            if (end == std::string::npos)
+                fail_ ("unterminated enumeration");
+            attr.type = text_.substr (pos_, end - pos_ + 1);
+            for (std::size_t i = 1; i < attr.type.size (); ++i)  {
+                const   char *const space = " \t\r\n";
+                const   std::size_t next = attr.type.find_first_of ("|)", i);
+                const   std::size_t first =
+                    attr.type.find_first_not_of (space, i);
+
+                if (first >= next)
+                    fail_ ("empty value in enumeration");
+
+                const   std::size_t last =
+                    attr.type.find_last_not_of (space, next - 1);
+
+                attr.values.push_back (
+                    attr.type.substr (first, last + 1 - first));
+                i = next;
+            }
+
+           // It goes in a comment, so it is made one line
+           //
+            attr.type = "(" + attr.values [0];
+            for (std::size_t i = 1; i < attr.values.size (); ++i)
+                attr.type += " | " + attr.values [i];
+            attr.type += ")";
+            pos_ = end + 1;
+        }
+        else  {
+            attr.type = name_ ();
+            if (attr.type == "NOTATION")  {
+                skip_space_ ();
+
+                const   std::size_t end = text_.find (')', pos_);
+
+                if (end == std::string::npos)
+                    fail_ ("unterminated notation list");
+                attr.type += " " + text_.substr (pos_, end - pos_ + 1);
+                pos_ = end + 1;
+            }
+        }
+
+        skip_space_ ();
+        if (pos_ < text_.size () && text_ [pos_] == '#')  {
+            attr.presence = name_ ();
+            if (attr.presence == "#FIXED")
+                attr.presence += " \"" + quoted_ () + "\"";
+        }
+        else
+            attr.presence = "\"" + quoted_ () + "\"";
+
+       // The first declaration of an attribute is binding
+       //
+        bool    found = false;
+
+        for (std::size_t i = 0; i < element.attributes.size (); ++i)
+            found = found || element.attributes [i].name == attr.name;
+        if (! found)
+            element.attributes.push_back (attr);
+    }
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+static const char *const    cpp_keywords [] =
+{
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor",
+    "bool", "break", "case", "catch", "char", "class", "compl", "const",
+    "constexpr", "const_cast", "continue", "decltype", "default", "delete",
+    "do", "double", "dynamic_cast", "else", "enum", "explicit", "export",
+    "extern", "false", "float", "for", "friend", "goto", "if", "inline",
+    "int", "long", "mutable", "namespace", "new", "noexcept", "not",
+    "not_eq", "nullptr", "operator", "or", "or_eq", "private", "protected",
+    "public", "register", "reinterpret_cast", "return", "short", "signed",
+    "sizeof", "static", "static_assert", "static_cast", "struct", "switch",
+    "template", "this", "throw", "true", "try", "typedef", "typeid",
+    "typename", "union", "unsigned", "using", "virtual", "void", "volatile",
+    "while", "xor", "xor_eq", NULL
+};
+
+// A C++ identifier made of an XML name. Member names are lower case with
+// underscores (HM_REQUEST -> hm_request) and struct names are capitalized
+// words (HM_REQUEST -> HmRequest), so they never hide each other.
+//
+static std::string
+identifier (const std::string &name, bool member)  {
+
+    std::string id;
+    bool        word_start = true;
+
+    for (std::size_t i = 0; i < name.size (); ++i)  {
+        const   unsigned char   c = name [i];
+
+        if (! std::isalnum (c))  {
+            if (member)
+                id += '_';
+            word_start = true;
+        }
+        else if (! member && word_start)  {
+            id += std::toupper (c);
+            word_start = false;
+        }
+        else
+            id += std::tolower (c);
+    }
+    if (id.empty () || std::isdigit (static_cast<unsigned char>(id [0])))
+        id.insert (0, "_");
+    for (const char *const *kw = cpp_keywords; *kw; ++kw)
+        if (id == *kw)  {
+            id += '_';
+            break;
+        }
+
+    return (id);
+}
+
+// ----------------------------------------------------------------------------
+
+static const char *cpp_type (const std::string &type)  {
+
+    if (type == "string")
+        return ("std::string");
+    if (type == "int")
+        return ("int");
+    if (type == "unsigned")
+        return ("unsigned int");
+    if (type == "long")
+        return ("long");
+    if (type == "double")
+        return ("double");
+    if (type == "bool")
+        return ("bool");
+    if (type == "timestamp")
+        return ("hmxml::XMLTimeStamp");
+
+    return (NULL);
+}
+
+// ----------------------------------------------------------------------------
+
+// Gives the structs and their members their C++ names and types, and puts
+// the structs in an order where every struct comes after the ones it
+// contains. A child that contains its parent is made a vector, since a
+// struct can't contain itself.
+//
+static void
+resolve (ElementMap &elements,
+         const std::string &name,
+         std::map<std::string, int> &state,
+         std::set<std::string> &struct_names,
+         std::vector<std::string> &order)  {
+
+    DtdElement  &element = elements [name];
+
+    state [name] = 1;
+
+    std::set<std::string>   members;
+
+    element.cpp_name = identifier (element.name, false);
+    while (! struct_names.insert (element.cpp_name).second)
+        element.cpp_name += '_';
+    for (std::size_t i = 0; i < element.attributes.size (); ++i)  {
+        DtdAttribute    &attr = element.attributes [i];
+
+        attr.member = identifier (attr.name, true);
+        while (! members.insert (attr.member).second)
+            attr.member += '_';
+    }
+    for (std::size_t i = 0; i < element.children.size (); ++i)  {
+        DtdChild    &child = element.children [i];
+
+        if (! elements [child.name].declared)
+            throw std::runtime_error ("DTD error: element '" + child.name +
+                                      "' is used but not declared");
+
+        child.member = identifier (child.name, true);
+        while (! members.insert (child.member).second)
+            child.member += '_';
+
+        if (state [child.name] == 1)
+            child.repeated = true;
+        else if (state [child.name] == 0)
+            resolve (elements, child.name, state, struct_names, order);
+    }
+
+    state [name] = 2;
+    order.push_back (name);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+static std::string guard_name (const std::string &file)  {
+
+    const   std::size_t slash = file.rfind ('/');
+    std::string         guard = "_INCLUDED_";
+
+    for (std::size_t i = slash == std::string::npos ? 0 : slash + 1;
+         i < file.size (); ++i)
+        guard += std::isalnum (static_cast<unsigned char>(file [i]))
+            ? file [i] : '_';
+
+    return (guard);
+}
+
+// ----------------------------------------------------------------------------
+
+static void
+generate (std::ostream &os,
+          const ElementMap &elements,
+          const std::vector<std::string> &order,
+          const std::string &dtd_file,
+          const std::string &name_space,
+          const std::string &guard)  {
+
+    os << "// Generated by dtd_codegen from " << dtd_file << "\n"
+          "// Do not edit. Regenerate it from the DTD.\n"
+          "\n"
+          "#ifndef " << guard << "\n"
+          "#define " << guard << " 0\n"
+          "\n"
+          "#include <optional>\n"
+          "#include <string>\n"
+          "#include <tuple>\n"
+          "#include <vector>\n"
+          "\n"
+          "#include <XMLBinder.h>\n"
+          "#include <XMLTypedValue.h>\n"
+          "#include <XMLWriter.h>\n"
+          "\n"
+          "// -------------------------------------------------------------"
+          "---------------\n"
+          "\n"
+          "namespace " << name_space << "\n"
+          "{\n"
+          "\n";
+
+    for (std::size_t i = 0; i < order.size (); ++i)
+        os << "struct  " << elements.at (order [i]).cpp_name << ";\n";
+    os << "\n";
+
+   // The structs
+   //
+    for (std::size_t i = 0; i < order.size (); ++i)  {
+        const   DtdElement  &element = elements.at (order [i]);
+
+        os << "// <!ELEMENT " << element.name << " " << element.content
+           << ">\n";
+        if (element.text)
+            os << "// NOTE: Character data is not bound.\n";
+        if (element.any)
+            os << "// NOTE: ANY content is not bound. Don't bind it in "
+                  "strict mode.\n";
+        os << "//\n"
+              "struct  " << element.cpp_name << "  {\n";
+        if (! element.attributes.empty ())
+            os << "\n";
+        for (std::size_t j = 0; j < element.attributes.size (); ++j)  {
+            const   DtdAttribute    &attr = element.attributes [j];
+
+            os << "    ";
+            if (attr.optional)
+                os << "std::optional<" << attr.cpp_type << ">";
+            else
+                os << attr.cpp_type;
+            os << "  " << attr.member << ";  // " << attr.name << " "
+               << attr.type << " " << attr.presence << "\n";
+        }
+        if (! element.children.empty ())
+            os << "\n";
+        for (std::size_t j = 0; j < element.children.size (); ++j)  {
+            const   DtdChild    &child = element.children [j];
+            const   std::string &type = elements.at (child.name).cpp_name;
+
+            if (child.repeated)
+                os << "    std::vector<" << type << ">  " << child.member
+                   << ";\n";
+            else if (child.optional)
+                os << "    std::optional<" << type << ">  " << child.member
+                   << ";\n";
+            else
+                os << "    " << type << "  " << child.member << ";\n";
+        }
+        os << "};\n\n";
+    }
+
+    os << "} // namespace " << name_space << "\n"
+          "\n"
+          "// -------------------------------------------------------------"
+          "---------------\n"
+          "\n"
+          "namespace hmxml\n"
+          "{\n"
+          "\n";
+
+   // The bindings
+   //
+    for (std::size_t i = 0; i < order.size (); ++i)  {
+        const   DtdElement  &element = elements.at (order [i]);
+        const   std::string type = name_space + "::" + element.cpp_name;
+        const   std::size_t num_members =
+            element.attributes.size () + element.children.size ();
+        std::size_t         count = 0;
+
+        os << "template<>\n"
+              "struct  XMLBinding<" << type << ">  {\n"
+              "\n"
+              "    static constexpr const char *element = \""
+           << element.name << "\";\n";
+        for (std::size_t j = 0; j < element.attributes.size (); ++j)  {
+            const   DtdAttribute    &attr = element.attributes [j];
+
+            if (attr.values.empty ())
+                continue;
+            os << "    static constexpr const char *" << attr.member
+               << "_values [] =\n"
+                  "        { ";
+            for (std::size_t k = 0; k < attr.values.size (); ++k)
+                os << "\"" << attr.values [k] << "\", ";
+            os << "NULL };\n";
+        }
+        os << "\n"
+              "    static constexpr auto members ()  {\n"
+              "\n"
+              "        return (std::make_tuple (";
+        for (std::size_t j = 0; j < element.attributes.size (); ++j)  {
+            const   DtdAttribute    &attr = element.attributes [j];
+
+            os << "\n            XMLbind_attr (\"" << attr.name << "\", &"
+               << type << "::" << attr.member;
+            if (! attr.values.empty ())
+                os << ", " << (attr.presence == "#REQUIRED" ? "true" : "false")
+                   << ", " << attr.member << "_values";
+            else if (attr.presence == "#REQUIRED")
+                os << ", true";
+            os << ")" << (++count < num_members ? "," : "");
+        }
+        for (std::size_t j = 0; j < element.children.size (); ++j)  {
+            const   DtdChild    &child = element.children [j];
+
+            os << "\n            "
+               << (child.repeated ? "XMLbind_children" : "XMLbind_child")
+               << " (\"" << child.name << "\", &" << type << "::"
+               << child.member << (child.optional ? ")" : ", true)")
+               << (++count < num_members ? "," : "");
+        }
+        os << "));\n"
+              "    }\n"
+              "};\n"
+              "\n";
+    }
+
+    os << "} // namespace hmxml\n"
+          "\n"
+          "// -------------------------------------------------------------"
+          "---------------\n"
+          "\n"
+          "namespace " << name_space << "\n"
+          "{\n"
+          "\n"
+          "// Writes object out as an element, and its children as child "
+          "elements.\n"
+          "// Children and attributes that are not present are left out. "
+          "Optional\n"
+          "// string attributes are left out, if they are empty.\n"
+          "//\n";
+
+    for (std::size_t i = 0; i < order.size (); ++i)
+        os << "inline void XMLwrite (hmxml::XMLWriter &writer, const "
+           << elements.at (order [i]).cpp_name << " &object);\n";
+    os << "\n";
+
+   // The serializers
+   //
+    for (std::size_t i = 0; i < order.size (); ++i)  {
+        const   DtdElement  &element = elements.at (order [i]);
+        const   bool        empty =
+            element.attributes.empty () && element.children.empty ();
+
+        os << "// ---------------------------------------------------------"
+              "-------------------\n"
+              "\n"
+              "inline void XMLwrite (hmxml::XMLWriter &writer, const "
+           << element.cpp_name << (empty ? " &" : " &object") << ")  {\n"
+              "\n";
+        if (! element.attributes.empty ())
+            os << "    char    buffer [hmxml::XMLFORMAT_BUFFER_SIZE];\n"
+                  "\n";
+        os << "    writer.write_open_tag (\"" << element.name << "\");\n";
+        for (std::size_t j = 0; j < element.attributes.size (); ++j)  {
+            const   DtdAttribute    &attr = element.attributes [j];
+
+            os << "    ";
+            if (attr.optional)
+                os << "if (object." << attr.member << ")\n"
+                      "        ";
+            else if (attr.presence != "#REQUIRED" &&
+                     attr.cpp_type == "std::string")
+                os << "if (! object." << attr.member << ".empty ())\n"
+                      "        ";
+            os << "writer.write_attribute (\"" << attr.name
+               << "\", hmxml::XMLformat ("
+               << (attr.optional ? "*object." : "object.") << attr.member
+               << ", buffer));\n";
+        }
+        for (std::size_t j = 0; j < element.children.size (); ++j)  {
+            const   DtdChild    &child = element.children [j];
+
+            if (child.repeated)
+                os << "    for (std::size_t i = 0; i < object." << child.member
+                   << ".size (); ++i)\n"
+                      "        XMLwrite (writer, object." << child.member
+                   << " [i]);\n";
+            else if (child.optional)
+                os << "    if (object." << child.member << ")\n"
+                      "        XMLwrite (writer, *object." << child.member
+                   << ");\n";
+            else
+                os << "    XMLwrite (writer, object." << child.member
+                   << ");\n";
+        }
+        os << "    writer.write_close_tag ();\n"
+              "    return;\n"
+              "}\n"
+              "\n";
+    }
+
+    os << "} // namespace " << name_space << "\n"
+          "\n"
+          "// -------------------------------------------------------------"
+          "---------------\n"
+          "\n"
+          "#undef " << guard << "\n"
+          "#define " << guard << " 1\n"
+          "#endif    // " << guard << "\n";
+
+    return;
+}
+
+// ----------------------------------------------------------------------------
+
+int main (int argC, char *argV [])  {
+
+    std::string                         dtd_file;
+    std::string                         out_file;
+    std::string                         name_space = "xmlgen";
+    std::map<std::string, std::string>  types;  // ELEM@ATTR -> type
+
+    for (int argInd = 1; argInd < argC; ++argInd)  {
+        if (! ::strncmp (argV [argInd], "-o=", 3))
+            out_file = argV [argInd] + 3;
+        else if (! ::strncmp (argV [argInd], "-n=", 3))
+            name_space = argV [argInd] + 3;
+        else if (! ::strncmp (argV [argInd], "-t=", 3))  {
+            const   std::string arg = argV [argInd] + 3;
+            const   std::size_t eq = arg.rfind ('=');
+
+            if (eq == std::string::npos || arg.find ('@') > eq ||
+                cpp_type (arg.substr (eq + 1)) == NULL)  {
+                usage ();
+                return (EXIT_FAILURE);
+            }
+            types [arg.substr (0, eq)] = arg.substr (eq + 1);
+        }
+        else if (argV [argInd] [0] != '-' && dtd_file.empty ())
+            dtd_file = argV [argInd];
+        else  {
+            usage ();
+            return (EXIT_FAILURE);
+        }
+    }
+    if (dtd_file.empty ())  {
+        usage ();
+        return (EXIT_FAILURE);
+    }
+
+    try  {
+        std::ifstream   dtd_stream (dtd_file.c_str (), std::ios::binary);
+
+        if (! dtd_stream)
+            throw std::runtime_error ("Cannot open " + dtd_file);
+
+        std::ostringstream  text;
+
+        text << dtd_stream.rdbuf ();
+
+        ElementMap                  elements;
+        std::vector<std::string>    declared;
+
+        DtdReader (text.str (), elements).read (declared);
+        if (declared.empty ())
+            throw std::runtime_error ("DTD error: no element is declared");
+
+        for (ElementMap::iterator iter = elements.begin ();
+             iter != elements.end (); ++iter)  {
+            if (! iter->second.declared)  {
+                if (iter->second.attributes.empty ())
+                    continue;  // Used, but not declared. Caught below.
+                throw std::runtime_error ("DTD error: attributes of '" +
+                                          iter->first +
+                                          "' are declared, but it isn't");
+            }
+
+            std::vector<DtdAttribute>   &attrs = iter->second.attributes;
+
+            for (std::size_t i = 0; i < attrs.size (); ++i)  {
+                const   std::map<std::string, std::string>::iterator titer =
+                    types.find (iter->first + "@" + attrs [i].name);
+
+                if (titer != types.end ())  {
+                    attrs [i].cpp_type = cpp_type (titer->second);
+                    attrs [i].optional = attrs [i].presence == "#IMPLIED";
+                    types.erase (titer);
+                }
+                else
+                    attrs [i].cpp_type = "std::string";
+            }
+        }
+        if (! types.empty ())
+            throw std::runtime_error ("No attribute " +
+                                      types.begin ()->first +
+                                      " in the DTD (-t)");
+
+        std::map<std::string, int>  state;
+        std::set<std::string>       struct_names;
+        std::vector<std::string>    order;
+
+        for (std::size_t i = 0; i < declared.size (); ++i)
+            if (state [declared [i]] == 0)
+                resolve (elements, declared [i], state, struct_names, order);
+
+        if (out_file.empty ())
+            generate (std::cout, elements, order, dtd_file, name_space,
+                      "_INCLUDED_dtd_codegen_h");
+        else  {
+            std::ofstream   out (out_file.c_str ());
+
+            generate (out, elements, order, dtd_file, name_space,
+                      guard_name (out_file));
+            if (! out)
+                throw std::runtime_error ("Cannot write " + out_file);
+        }
+    }
+    catch (const std::exception &ex)  {
+        std::cerr << "dtd_codegen: " << ex.what () << std::endl;
+        return (EXIT_FAILURE);
+    }
+
+    return (EXIT_SUCCESS);
+}
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,167 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <XMLParser.h>
+
+using namespace hmxml;
+
+// ---------------------------------------------------------------------------
+
+//
+// This measures the per message latency of XMLParser::parse_string() for
+// small messages, shaped like our data requests (see data_query.xml).
+// It reports the p50, p99 and p99.9 latencies for each message size, with
+// and without the low latency mode.
+//
+
+// ---------------------------------------------------------------------------
+
+void usage ()  {
+
+    std::cout << "\nUsage:\n"
+                 "    latency_bench [iterations]\n\n"
+                 "Parses each message size <iterations> times (defaults to "
+                 "100000)\nand prints the latency percentiles in "
+                 "nanoseconds.\n"
+              << std::endl;
+}
+
+// ---------------------------------------------------------------------------
+
+// Builds a request with as many symbols as it takes to reach msg_size bytes
+//
+static void build_message (std::string &msg, std::size_t msg_size)  {
+
+    static  const   char    *const  header =
+        "<HM_REQUEST ID=\"r0001\" TARGET=\"DMS\" TYPE=\"TICK_DATA\" "
+        "CLIENT_PROCESS_ID=\"23456\" CLIENT_USER_NAME=\"hmoein\">";
+    static  const   char    *const  symbol =
+        "<SYMBOL ID=\"IBM\" START=\"20100716083000\" "
+        "END=\"20100716093000\"><FIELD TICK_TYPE=\"ASK\"/></SYMBOL>";
+    static  const   char    *const  trailer = "</HM_REQUEST>";
+
+    msg = header;
+    do
+        msg += symbol;
+    while (msg.size () + ::strlen (symbol) + ::strlen (trailer) <= msg_size);
+    msg += trailer;
+
+    return;
+}
+
+// ---------------------------------------------------------------------------
+
+static void print_percentiles (std::size_t msg_size,
+                               const char *const mode,
+                               std::vector<long long> &latencies)  {
+
+    std::sort (latencies.begin (), latencies.end ());
+
+    const   std::size_t n = latencies.size ();
+
+    std::printf ("%8zu  %-12s %10lld %10lld %10lld %10lld\n",
+                 msg_size, mode,
+                 latencies [n / 2],
+                 latencies [(n * 99) / 100],
+                 latencies [(n * 999) / 1000],
+                 latencies [n - 1]);
+    return;
+}
+
+// ---------------------------------------------------------------------------
+
+static void run (std::size_t msg_size, std::size_t iterations, bool low_lat)  {
+
+    typedef std::chrono::steady_clock   Clock;
+
+    std::string msg;
+
+    build_message (msg, msg_size);
+
+    XMLTreeNodes::attr_vector   attr_vector;
+    XMLTreeNodes                pn (attr_vector);
+    XMLParser                   parser (pn, attr_vector);
+    std::vector<long long>      latencies;
+
+    if (low_lat)
+        parser.set_low_latency_mode ();
+    latencies.reserve (iterations);
+
+   // Warm up, so the recycled tree reaches its steady state
+   //
+    for (std::size_t i = 0; i < 1000; ++i)
+        parser.parse_string (msg.c_str (), msg.size ());
+
+    for (std::size_t i = 0; i < iterations; ++i)  {
+        const   Clock::time_point   start = Clock::now ();
+
+        parser.parse_string (msg.c_str (), msg.size ());
+
+        const   Clock::time_point   end = Clock::now ();
+
+        latencies.push_back (
+            std::chrono::duration_cast<std::chrono::nanoseconds>
+                (end - start).count ());
+    }
+
+    if (parser.has_fatal_error ())
+        std::cerr << parser.fatal_error () << std::endl;
+
+    print_percentiles (msg.size (), low_lat ? "low-latency" : "default",
+                       latencies);
+    return;
+}
+
+// ---------------------------------------------------------------------------
+
+int main (int argC, char *argV [])  {
+
+    std::size_t iterations = 100000;
+
+    if (argC > 2 || (argC == 2 && argV [1][0] == '-'))  {
+        usage ();
+        return (EXIT_FAILURE);
+    }
+    if (argC == 2)
+        iterations = std::strtoul (argV [1], NULL, 10);
+    if (iterations < 1000)
+        iterations = 1000;
+
+    static  const   std::size_t sizes [] =
+        { 256, 512, 1024, 2048, 4096, 8192 };
+
+    std::printf ("%8s  %-12s %10s %10s %10s %10s\n",
+                 "bytes", "mode", "p50(ns)", "p99(ns)", "p99.9(ns)",
+                 "max(ns)");
+
+    try  {
+        for (std::size_t i = 0; i < sizeof (sizes) / sizeof (sizes [0]); ++i)
+            for (int low_lat = 0; low_lat < 2; ++low_lat)
+                run (sizes [i], iterations, low_lat != 0);
+    }
+    catch (const std::exception &e)  {
+        std::cerr << "Exception thrown: " << e.what () << std::endl;
+        return (EXIT_FAILURE);
+    }
+
+    return (EXIT_SUCCESS);
+}
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
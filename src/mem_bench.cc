@@ -0,0 +1,156 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <XMLParser.h>
+
+#include "xml_doc_generator.h"
+
+using namespace hmxml;
+
+// ---------------------------------------------------------------------------
+
+//
+// This measures how much memory a parsed tree takes relative to its source
+// document, for document sizes from 1 KB up to a given maximum (multiplied
+// by 16 at each step). It prints one CSV line per shape and size:
+//
+//   shape,doc_bytes,nodes,tree_bytes,attr_vector_bytes,attr_slack_bytes,
+//   overhead_ratio,rss_delta_bytes,peak_rss_bytes
+//
+// tree_bytes and attr_vector_bytes come from XMLTreeNodes::bytes_used() and
+// XMLTreeNodes::attr_vector_bytes(). overhead_ratio is their sum over
+// doc_bytes. rss_delta_bytes is the growth of the resident set across the
+// parse, which also shows the allocator overhead. peak_rss_bytes is the
+// peak resident set of the process so far.
+//
+
+// ---------------------------------------------------------------------------
+
+void usage ()  {
+
+    std::cout << "\nUsage:\n"
+                 "    mem_bench [options]\n\n"
+                 "Options:\n"
+                 "    -m=nnn      Largest document size in bytes. "
+                 "Defaults to 67108864.\n"
+                 "                Use several GB for capacity planning runs.\n"
+              << std::endl;
+}
+
+// ---------------------------------------------------------------------------
+
+static std::size_t current_rss ()  {
+
+    std::size_t pages = 0;
+    std::size_t resident = 0;
+    FILE        *statm = ::fopen ("/proc/self/statm", "r");
+
+    if (statm == NULL)
+        return (0);
+    if (::fscanf (statm, "%zu %zu", &pages, &resident) != 2)
+        resident = 0;
+    ::fclose (statm);
+
+    return (resident * ::sysconf (_SC_PAGESIZE));
+}
+
+// ---------------------------------------------------------------------------
+
+static std::size_t peak_rss ()  {
+
+    struct  rusage  usage;
+
+    ::getrusage (RUSAGE_SELF, &usage);
+    return (std::size_t (usage.ru_maxrss) * 1024);  // KB on Linux
+}
+
+// ---------------------------------------------------------------------------
+
+static void run (XMLDocGenerator::DocShape shape, std::size_t size)  {
+
+    std::string doc;
+
+    XMLDocGenerator::generate (shape, size, doc);
+
+    const   std::size_t rss_before = current_rss ();
+
+    XMLTreeNodes::attr_vector   attr_vector;
+    XMLTreeNodes                pn (attr_vector);
+    XMLParser                   parser (pn, attr_vector);
+
+    parser.parse_string (doc.c_str (), doc.size ());
+    if (parser.has_fatal_error ())  {
+        std::cerr << parser.fatal_error () << std::endl;
+        return;
+    }
+
+    const   std::size_t rss_after = current_rss ();
+    const   std::size_t tree_bytes = pn.bytes_used ();
+    const   std::size_t attr_bytes =
+        XMLTreeNodes::attr_vector_bytes (attr_vector);
+
+    std::printf ("%s,%zu,%zu,%zu,%zu,%zu,%.3f,%zu,%zu\n",
+                 XMLDocGenerator::shape_name (shape),
+                 doc.size (),
+                 std::size_t (std::distance (pn.preorder_begin (),
+                                             pn.preorder_end ())),
+                 tree_bytes,
+                 attr_bytes,
+                 XMLTreeNodes::attr_vector_slack_bytes (attr_vector),
+                 double (tree_bytes + attr_bytes) / double (doc.size ()),
+                 rss_after > rss_before ? rss_after - rss_before : 0,
+                 peak_rss ());
+    std::fflush (stdout);
+
+    return;
+}
+
+// ---------------------------------------------------------------------------
+
+int main (int argC, char *argV [])  {
+
+    std::size_t max_size = 64 * 1024 * 1024;
+
+    for (int argInd = 1; argInd < argC; ++argInd)  {
+        if (! ::strncmp (argV [argInd], "-m=", 3))
+            max_size = std::strtoull (argV [argInd] + 3, NULL, 10);
+        else  {
+            usage ();
+            return (EXIT_FAILURE);
+        }
+    }
+
+    std::printf ("shape,doc_bytes,nodes,tree_bytes,attr_vector_bytes,"
+                 "attr_slack_bytes,overhead_ratio,rss_delta_bytes,"
+                 "peak_rss_bytes\n");
+
+    try  {
+        for (int shape = 0; shape < XMLDocGenerator::ds_num_shapes; ++shape)
+            for (std::size_t size = 1024; size <= max_size; size *= 16)
+                run (XMLDocGenerator::DocShape (shape), size);
+    }
+    catch (const std::exception &e)  {
+        std::cerr << "Exception thrown: " << e.what () << std::endl;
+        return (EXIT_FAILURE);
+    }
+
+    return (EXIT_SUCCESS);
+}
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
@@ -0,0 +1,327 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <XMLBufferedWriter.h>
+#include <XMLParser.h>
+#include <XMLWriter.h>
+
+#include "xml_doc_generator.h"
+
+using namespace hmxml;
+
+// ---------------------------------------------------------------------------
+
+//
+// This runs a set of benchmarks over synthetic documents of different
+// shapes (see xml_doc_generator.h) and prints the results as CSV, one line
+// per benchmark and shape:
+//
+//   benchmark,shape,doc_bytes,nodes,iterations,ns_per_op,mb_per_sec
+//
+// ns_per_op is per document for parse, teardown and the serializers, and
+// per node for get_attr and traversal. mb_per_sec is relative to the size
+// of the source document (or of the output, for the serializers).
+//
+
+// ---------------------------------------------------------------------------
+
+void usage ()  {
+
+    std::cout << "\nUsage:\n"
+                 "    xml_bench [options]\n\n"
+                 "Options:\n"
+                 "    -s=nnn      Size of each generated document in bytes. "
+                 "Defaults to 1048576.\n"
+                 "    -t=nnn      Minimum time per benchmark in "
+                 "milliseconds. Defaults to 200.\n"
+              << std::endl;
+}
+
+// ---------------------------------------------------------------------------
+
+typedef std::chrono::steady_clock   Clock;
+
+static  long long   min_bench_ns = 200LL * 1000000LL;
+
+// Runs func until at least min_bench_ns have passed, and returns the
+// average time of one run in nanoseconds.
+//
+template<class xml_FUNC>
+static double time_it (xml_FUNC func, std::size_t &iterations)  {
+
+    const   Clock::time_point   start = Clock::now ();
+    long long                   elapsed = 0;
+
+    iterations = 0;
+    do  {
+        func ();
+        iterations += 1;
+        elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>
+                      (Clock::now () - start).count ();
+    } while (elapsed < min_bench_ns);
+
+    return (double (elapsed) / double (iterations));
+}
+
+// ---------------------------------------------------------------------------
+
+static void report (const char *bench, XMLDocGenerator::DocShape shape,
+                    std::size_t doc_bytes, std::size_t nodes,
+                    std::size_t iterations, double ns_per_op,
+                    std::size_t bytes_per_op)  {
+
+    const   double  mb_per_sec =
+        bytes_per_op ? (double (bytes_per_op) / (1024.0 * 1024.0)) /
+                           (ns_per_op / 1e9)
+                     : 0.0;
+
+    std::printf ("%s,%s,%zu,%zu,%zu,%.2f,%.2f\n",
+                 bench, XMLDocGenerator::shape_name (shape),
+                 doc_bytes, nodes, iterations, ns_per_op, mb_per_sec);
+    std::fflush (stdout);
+    return;
+}
+
+// ---------------------------------------------------------------------------
+
+// Calls get_attr() for the last attribute of every node, which is the
+// worst case for the linear attribute lookup.
+//
+static std::size_t lookup_attrs (const XMLTreeNodes &root)  {
+
+    std::vector<const XMLTreeNodes *>   stack;
+    std::size_t                         found = 0;
+
+    stack.push_back (&root);
+    while (! stack.empty ())  {
+        const   XMLTreeNodes    *node = stack.back ();
+
+        stack.pop_back ();
+        if (node->attr_begin () != node->attr_end ())  {
+            const   XMLTreeNodes::attr_const_iterator last =
+                node->attr_end () - 1;
+
+            if (node->get_attr (last->get_name ()))
+                found += 1;
+        }
+        if (node->get_sibling () && node != &root)
+            stack.push_back (node->get_sibling ());
+        if (node->get_child ())
+            stack.push_back (node->get_child ());
+    }
+
+    return (found);
+}
+
+// ---------------------------------------------------------------------------
+
+// Walks the whole tree with the child/sibling iterators
+//
+static std::size_t traverse (const XMLTreeNodes &root)  {
+
+    std::vector<XMLTreeNodes::const_iterator>   stack;
+    std::size_t                                 count = 1;
+
+    stack.push_back (root.child_begin ());
+    while (! stack.empty ())  {
+        XMLTreeNodes::const_iterator    &itr = stack.back ();
+
+        if (itr == root.child_sibling_end ())  {
+            stack.pop_back ();
+            continue;
+        }
+
+        const   XMLTreeNodes::const_iterator    child = itr->child_begin ();
+
+        count += 1;
+        ++itr;
+        if (child != root.child_sibling_end ())
+            stack.push_back (child);
+    }
+
+    return (count);
+}
+
+// ---------------------------------------------------------------------------
+
+template <class xml_WRITER>
+static void write_node (xml_WRITER &writer, const XMLTreeNodes &node)  {
+
+    writer.write_open_tag (node.get_name ());
+    for (XMLTreeNodes::attr_const_iterator itr = node.attr_begin ();
+         itr != node.attr_end (); ++itr)
+        writer.write_attribute (itr->get_name (), itr->get_value ());
+    for (XMLTreeNodes::const_iterator itr = node.child_begin ();
+         itr != node.child_sibling_end (); ++itr)
+        write_node (writer, *itr);
+    writer.write_close_tag ();
+
+    return;
+}
+
+// ---------------------------------------------------------------------------
+
+static void run_shape (XMLDocGenerator::DocShape shape, std::size_t size)  {
+
+    std::string doc;
+    std::size_t iterations = 0;
+    double      ns = 0;
+
+    XMLDocGenerator::generate (shape, size, doc);
+
+    XMLTreeNodes::attr_vector   attr_vector;
+    XMLTreeNodes                pn (attr_vector);
+    XMLParser                   parser (pn, attr_vector);
+
+   // Parse, with the tree recycled from one document to the next
+   //
+    ns = time_it ([&] () { parser.parse_string (doc.c_str (), doc.size ()); },
+                  iterations);
+    if (parser.has_fatal_error ())  {
+        std::cerr << parser.fatal_error () << std::endl;
+        return;
+    }
+
+    const   std::size_t nodes =
+        std::distance (pn.preorder_begin (), pn.preorder_end ());
+
+    report ("parse", shape, doc.size (), nodes, iterations, ns, doc.size ());
+
+   // Tear down of a freshly parsed tree. Only the destruction is timed.
+   //
+    {
+        long long   teardown_ns = 0;
+
+        ns = time_it ([&] ()  {
+            XMLTreeNodes::attr_vector   attrs;
+            XMLTreeNodes                *root = new XMLTreeNodes (attrs);
+
+            {
+                XMLParser   fresh_parser (*root, attrs);
+
+                fresh_parser.parse_string (doc.c_str (), doc.size ());
+            }
+
+            const   Clock::time_point   start = Clock::now ();
+
+            delete root;
+            attrs.clear ();
+            teardown_ns += std::chrono::duration_cast<std::chrono::nanoseconds>
+                               (Clock::now () - start).count ();
+        }, iterations);
+        report ("teardown", shape, doc.size (), nodes, iterations,
+                double (teardown_ns) / double (iterations), 0);
+    }
+
+    std::size_t sink = 0;
+
+    ns = time_it ([&] () { sink += lookup_attrs (pn); }, iterations);
+    report ("get_attr", shape, doc.size (), nodes, iterations,
+            ns / double (nodes), 0);
+
+    ns = time_it ([&] () { sink += traverse (pn); }, iterations);
+    report ("traverse", shape, doc.size (), nodes, iterations,
+            ns / double (nodes), 0);
+
+    std::string out_str;
+
+    ns = time_it ([&] () { out_str.clear (); pn.dump_xml (out_str); },
+                  iterations);
+    report ("dump_xml_string", shape, doc.size (), nodes, iterations, ns,
+            out_str.size ());
+
+    ns = time_it ([&] ()  {
+        out_str.clear ();
+        pn.dump_xml (out_str, XMLTreeNodes::df_compact);
+    }, iterations);
+    report ("dump_xml_compact", shape, doc.size (), nodes, iterations, ns,
+            out_str.size ());
+
+    std::ostringstream  out_strm;
+
+    ns = time_it ([&] ()  {
+        out_strm.str (std::string ());
+        pn.dump_xml (out_strm);
+    }, iterations);
+    report ("dump_xml_stream", shape, doc.size (), nodes, iterations, ns,
+            out_strm.str ().size ());
+
+    ns = time_it ([&] ()  {
+        out_strm.str (std::string ());
+
+        XMLStreamWriter<std::ostringstream> writer (out_strm);
+
+        write_node (writer, pn);
+    }, iterations);
+    report ("xml_writer", shape, doc.size (), nodes, iterations, ns,
+            out_strm.str ().size ());
+
+    ns = time_it ([&] ()  {
+        out_str.clear ();
+
+        XMLStringSink                       str_sink (out_str);
+        XMLBufferedWriter<XMLStringSink>    writer (str_sink);
+
+        write_node (writer, pn);
+        writer.flush ();
+    }, iterations);
+    report ("buffered_writer", shape, doc.size (), nodes, iterations, ns,
+            out_str.size ());
+
+    if (sink == 0)
+        std::cerr << "No attributes or nodes found" << std::endl;
+
+    return;
+}
+
+// ---------------------------------------------------------------------------
+
+int main (int argC, char *argV [])  {
+
+    std::size_t size = 1024 * 1024;
+
+    for (int argInd = 1; argInd < argC; ++argInd)  {
+        if (! ::strncmp (argV [argInd], "-s=", 3))
+            size = std::strtoul (argV [argInd] + 3, NULL, 10);
+        else if (! ::strncmp (argV [argInd], "-t=", 3))
+            min_bench_ns =
+                std::strtoll (argV [argInd] + 3, NULL, 10) * 1000000LL;
+        else  {
+            usage ();
+            return (EXIT_FAILURE);
+        }
+    }
+
+    std::printf ("benchmark,shape,doc_bytes,nodes,iterations,"
+                 "ns_per_op,mb_per_sec\n");
+
+    try  {
+        for (int shape = 0; shape < XMLDocGenerator::ds_num_shapes; ++shape)
+            run_shape (XMLDocGenerator::DocShape (shape), size);
+    }
+    catch (const std::exception &e)  {
+        std::cerr << "Exception thrown: " << e.what () << std::endl;
+        return (EXIT_FAILURE);
+    }
+
+    return (EXIT_SUCCESS);
+}
+
+// ----------------------------------------------------------------------------
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
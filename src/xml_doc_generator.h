@@ -0,0 +1,196 @@
+// Hossein Moein
+// March 24, 2018
+// Copyright (C) 2018-2019 Hossein Moein
+// Distributed under the BSD Software License (see file License)
+
+#ifndef _INCLUDED_xml_doc_generator_h
+#define _INCLUDED_xml_doc_generator_h 0
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// ----------------------------------------------------------------------------
+
+namespace hmxml
+{
+
+// This generates synthetic XML documents for the benchmarks. Each shape
+// stresses a different part of the parser and the tree. A document is grown
+// until it is at least target_size bytes long.
+//
+class   XMLDocGenerator  {
+
+    public:
+
+        typedef std::size_t size_type;
+
+        enum DocShape  {
+            ds_deep = 0,         // Deeply nested elements
+            ds_wide = 1,         // One root with a very large fan-out
+            ds_attr_heavy = 2,   // Many attributes per element
+            ds_long_values = 3,  // Few attributes with long values
+            ds_entity_heavy = 4, // Values full of entity/char references
+            ds_data_query = 5,   // data_query.xml requests, scaled up
+            ds_num_shapes = 6
+        };
+
+        static inline const char *shape_name (DocShape shape) throw ()  {
+
+            static  const   char    *const  names [ds_num_shapes] =
+                { "deep", "wide", "attr_heavy", "long_values",
+                  "entity_heavy", "data_query" };
+
+            return (names [shape]);
+        }
+
+        static inline std::string &
+        generate (DocShape shape, size_type target_size, std::string &doc)  {
+
+            doc.clear ();
+            doc.reserve (target_size + 4096);
+            doc += "<?xml version=\"1.0\"?>\n";
+
+            switch (shape)  {
+                case ds_deep: gen_deep_ (target_size, doc); break;
+                case ds_wide: gen_wide_ (target_size, doc); break;
+                case ds_attr_heavy: gen_attr_heavy_ (target_size, doc); break;
+                case ds_long_values:
+                    gen_long_values_ (target_size, doc);
+                    break;
+                case ds_entity_heavy:
+                    gen_entity_heavy_ (target_size, doc);
+                    break;
+                case ds_data_query:
+                default: gen_data_query_ (target_size, doc); break;
+            }
+
+            return (doc);
+        }
+
+    private:
+
+        static inline void
+        append_num_ (std::string &doc, size_type n)  {
+
+            char    buffer [32];
+
+            ::snprintf (buffer, sizeof (buffer), "%zu", n);
+            doc += buffer;
+        }
+
+       // Blocks of 256 nested levels, so the depth stays bounded while the
+       // document grows.
+       //
+        static inline void gen_deep_ (size_type target_size, std::string &doc) {
+
+            static  const   size_type   depth = 256;
+
+            doc += "<DEEP>";
+            for (size_type n = 0; doc.size () < target_size; ++n)  {
+                for (size_type i = 0; i < depth; ++i)  {
+                    doc += "<LEVEL ID=\"";
+                    append_num_ (doc, i);
+                    doc += "\">";
+                }
+                for (size_type i = 0; i < depth; ++i)
+                    doc += "</LEVEL>";
+            }
+            doc += "</DEEP>\n";
+        }
+
+        static inline void gen_wide_ (size_type target_size, std::string &doc) {
+
+            doc += "<WIDE>\n";
+            for (size_type n = 0; doc.size () < target_size; ++n)  {
+                doc += "  <ITEM ID=\"";
+                append_num_ (doc, n);
+                doc += "\"/>\n";
+            }
+            doc += "</WIDE>\n";
+        }
+
+        static inline void
+        gen_attr_heavy_ (size_type target_size, std::string &doc)  {
+
+            doc += "<ATTRS>\n";
+            while (doc.size () < target_size)  {
+                doc += "  <ITEM";
+                for (size_type i = 0; i < 32; ++i)  {
+                    doc += " A";
+                    append_num_ (doc, i);
+                    doc += "=\"V";
+                    append_num_ (doc, i);
+                    doc += "\"";
+                }
+                doc += "/>\n";
+            }
+            doc += "</ATTRS>\n";
+        }
+
+        static inline void
+        gen_long_values_ (size_type target_size, std::string &doc)  {
+
+            const   std::string value (4096, 'x');
+
+            doc += "<LONG>\n";
+            while (doc.size () < target_size)  {
+                doc += "  <ITEM VALUE=\"";
+                doc += value;
+                doc += "\" OTHER=\"";
+                doc += value;
+                doc += "\"/>\n";
+            }
+            doc += "</LONG>\n";
+        }
+
+        static inline void
+        gen_entity_heavy_ (size_type target_size, std::string &doc)  {
+
+            doc += "<ENTITIES>\n";
+            while (doc.size () < target_size)
+                doc += "  <ITEM CLIENT_MACHINE="
+                       "\"&quot;&lt;tickdb1.axiomif.&#9;.com&gt;&quot;"
+                       "&apos;&#13;&amp;&#x41;\"/>\n";
+            doc += "</ENTITIES>\n";
+        }
+
+        static inline void
+        gen_data_query_ (size_type target_size, std::string &doc)  {
+
+            doc += "<HM_REQUEST_GROUP ID=\"r0001\">\n";
+            for (size_type n = 0; doc.size () < target_size; ++n)  {
+                doc += "   <HM_REQUEST ID=\"r";
+                append_num_ (doc, n);
+                doc += "\" TARGET=\"DMS\" TYPE=\"TICK_DATA\"\n"
+                       "               REQUEST_PROTOCOL=\"XML-1.0\" "
+                       "REPLY_PROTOCOL=\"XML-1.0\"\n"
+                       "               CLIENT_PROCESS_ID=\"23456\" "
+                       "CLIENT_USER_NAME=\"hmoein\">\n"
+                       "       <SYMBOL ID=\"IBM\" START=\"20100716083000\"\n"
+                       "               END=\"20100716093000\"\n"
+                       "               REFERENCE=\"20100716\"\n"
+                       "               RETURN_TYPE=\"ADJUSTED\">\n"
+                       "          <FIELD TICK_TYPE=\"ASK\"/>\n"
+                       "          <FIELD TICK_TYPE=\"BID\"/>\n"
+                       "          <FIELD TICK_TYPE=\"TRADE\"/>\n"
+                       "       </SYMBOL>\n"
+                       "   </HM_REQUEST>\n";
+            }
+            doc += "</HM_REQUEST_GROUP>\n";
+        }
+};
+
+} // namespace hmxml
+
+// ----------------------------------------------------------------------------
+
+#undef _INCLUDED_xml_doc_generator_h
+#define _INCLUDED_xml_doc_generator_h 1
+#endif  // _INCLUDED_xml_doc_generator_h
+
+// Local Variables:
+// mode:C++
+// tab-width:4
+// c-basic-offset:4
+// End:
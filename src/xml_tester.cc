@@ -3,10 +3,29 @@
 // Copyright (C) 2018-2019 Hossein Moein
 // Distributed under the BSD Software License (see file License)
 
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <XMLAsyncIngest.h>
+#include <XMLBinder.h>
+#include <XMLCursor.h>
+#include <XMLIovecSink.h>
+#include <XMLParallelVisitor.h>
 #include <XMLParser.h>
 #include <XMLWriter.h>
 #include <XMLString.h>
 
+#include "data_query_gen.h"  // Generated from data_query.dtd
+
 using namespace hmxml;
 
 // ---------------------------------------------------------------------------
@@ -18,7 +37,10 @@ void usage ()  {
                  "Options:\n"
                  "    -v=xxx      Validation scheme [always | never | auto*]\n"
                  "    -n          Enable namespace processing. "
-                 "Defaults to off.\n\n"
+                 "Defaults to off.\n"
+                 "    -s          Print parse statistics (the library "
+                 "must be built\n"
+                 "                with XMLPARSER_STATS).\n\n"
                  "This program prints the number of elements, attributes,\n"
                  "white spaces and other non-white space characters in the "
                  "input file.\n\n"
@@ -43,6 +65,94 @@ class   ptxml_test_eq_name
 
 // ---------------------------------------------------------------------------
 
+// data_query.xml bound to structs
+//
+struct  DataField  {
+
+    std::string tick_type;
+};
+
+struct  DataSymbol  {
+
+    std::string             id;
+    XMLTimeStamp            start;
+    XMLTimeStamp            end;
+    unsigned int            reference;
+    std::vector<DataField>  fields;
+};
+
+struct  DataRequest  {
+
+    std::string             id;
+    std::string             target;
+    long                    client_process_id;
+    std::vector<DataSymbol> symbols;
+};
+
+struct  DataRequestGroup  {
+
+    std::string     id;
+    DataRequest     request;
+};
+
+namespace hmxml
+{
+
+template<>
+struct  XMLBinding<DataField>  {
+
+    static constexpr auto members ()  {
+
+        return (std::make_tuple (
+            XMLbind_attr ("TICK_TYPE", &DataField::tick_type)));
+    }
+};
+
+template<>
+struct  XMLBinding<DataSymbol>  {
+
+    static constexpr auto members ()  {
+
+        return (std::make_tuple (
+            XMLbind_attr ("ID", &DataSymbol::id),
+            XMLbind_attr ("START", &DataSymbol::start),
+            XMLbind_attr ("END", &DataSymbol::end),
+            XMLbind_attr ("REFERENCE", &DataSymbol::reference),
+            XMLbind_children ("FIELD", &DataSymbol::fields)));
+    }
+};
+
+template<>
+struct  XMLBinding<DataRequest>  {
+
+    static constexpr auto members ()  {
+
+        return (std::make_tuple (
+            XMLbind_attr ("ID", &DataRequest::id),
+            XMLbind_attr ("TARGET", &DataRequest::target),
+            XMLbind_attr ("CLIENT_PROCESS_ID",
+                          &DataRequest::client_process_id),
+            XMLbind_children ("SYMBOL", &DataRequest::symbols)));
+    }
+};
+
+template<>
+struct  XMLBinding<DataRequestGroup>  {
+
+    static constexpr const char *element = "HM_REQUEST_GROUP";
+
+    static constexpr auto members ()  {
+
+        return (std::make_tuple (
+            XMLbind_attr ("ID", &DataRequestGroup::id),
+            XMLbind_child ("HM_REQUEST", &DataRequestGroup::request)));
+    }
+};
+
+} // namespace hmxml
+
+// ---------------------------------------------------------------------------
+
 int main (int argC, char* argV[])  {
 
 
@@ -70,6 +180,7 @@ int main (int argC, char* argV[])  {
     XERCES_CPP_NAMESPACE::SAXParser::ValSchemes valScheme =
         XERCES_CPP_NAMESPACE::SAXParser::Val_Auto;
     bool                                        doNamespaces = false;
+    bool                                        doStats = false;
 
     // See if non validating dom parser configuration is requested.
     //
@@ -104,6 +215,10 @@ int main (int argC, char* argV[])  {
                  ! ::strcmp (argV [argInd], "-N"))  {
             doNamespaces = true;
         }
+        else if (! ::strcmp (argV [argInd], "-s") ||
+                 ! ::strcmp (argV [argInd], "-S"))  {
+            doStats = true;
+        }
         else
             std::cerr << "Unknown option '"
                       << argV[argInd]
@@ -131,9 +246,16 @@ int main (int argC, char* argV[])  {
             XMLTreeNodes    pn (attr_vector);
             XMLParser       parser (pn, attr_vector, valScheme,
                                         doNamespaces);
+            XMLParseStats   stats;
+
+            if (doStats)
+                parser.set_stats (&stats);
 
             parser.parse_file (xmlFile);
 
+            if (doStats)
+                std::cout << "STATISTICS:\n" << stats << std::endl;
+
             if (parser.has_warning ())  {
                 std::cout << "WARNINGS:" << std::endl;
 
@@ -169,6 +291,24 @@ int main (int argC, char* argV[])  {
 
                 std::cout << pn.dump_xml (str) << std::endl;
 
+               // The indented string dump must match the stream dump, and
+               // the compact one must be exactly as long as predicted.
+               //
+                std::ostringstream  strm;
+                std::string         indented;
+                std::string         compact;
+
+                pn.dump_xml (strm);
+                pn.dump_xml (indented, XMLTreeNodes::df_indented);
+                pn.dump_xml (compact, XMLTreeNodes::df_compact);
+                std::cout << "String dump formats: "
+                          << (indented == strm.str () &&
+                              compact.size () ==
+                                  pn.dump_size (XMLTreeNodes::df_compact) &&
+                              compact.find ('\n') == std::string::npos
+                                  ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
                // Testing the iterators.
                //
                 for (XMLTreeNodes::const_iterator itr = pn.child_begin ();
@@ -195,6 +335,526 @@ int main (int argC, char* argV[])  {
                     std::cout << "Name: " << (*itr)->get_name () << std::endl;
 
                 std::cout << std::endl << std::endl;
+
+               // Testing parser reuse. The second parse recycles the
+               // nodes and attributes of the first one.
+               //
+                std::string str2;
+
+                parser.parse_file (xmlFile);
+                pn.dump_xml (str2);
+                std::cout << "Parser reuse: "
+                          << (str == str2 ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the streaming parse. It must build the same tree.
+               //
+                std::ifstream   xml_strm (xmlFile, std::ios::binary);
+                std::string     str3;
+
+                parser.parse_stream (xml_strm, xmlFile);
+                pn.dump_xml (str3);
+                std::cout << "Stream parse: "
+                          << (str == str3 ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // A threaded parse of a pipe that stops at a fatal error,
+               // while the writer still holds the pipe open. It must not
+               // wait for the writer.
+               //
+                XMLTreeNodes::attr_vector   pipe_attrs;
+                XMLTreeNodes                pipe_pn (pipe_attrs);
+                XMLParser                   pipe_parser (pipe_pn, pipe_attrs);
+                int                         pipe_fds [2];
+                bool                        pipe_parsed = true;
+
+                if (::pipe (pipe_fds) == 0)  {
+                    static  const   char    bad_doc [] = "<A><B></A>";
+
+                    if (::write (pipe_fds [1], bad_doc,
+                                 sizeof (bad_doc) - 1) > 0)  {
+                        pipe_parser.set_threaded_input (true);
+                        pipe_parsed = pipe_parser.parse_fd (pipe_fds [0]);
+                    }
+                    ::close (pipe_fds [0]);
+                    ::close (pipe_fds [1]);
+                }
+                std::cout << "Abandoned pipe parse: "
+                          << (! pipe_parsed ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the read-ahead file input
+               //
+                std::string str5;
+
+                parser.set_file_input (XMLParser::fi_read_ahead, 64 * 1024);
+                parser.parse_file (xmlFile);
+                parser.set_file_input (XMLParser::fi_xerces);
+                pn.dump_xml (str5);
+                std::cout << "Read-ahead parse: "
+                          << (str == str5 ? "OK" : "FAILED")
+                          << " (stalled " << parser.input_stall_ns ()
+                          << " ns)" << std::endl << std::endl;
+
+               // The same for a read-ahead parse of a named pipe. Opening
+               // the FIFO for reading and writing here keeps it open on the
+               // writing side.
+               //
+                char    fifo_name [64];
+                bool    fifo_parsed = true;
+
+                std::snprintf (fifo_name, sizeof (fifo_name),
+                               "/tmp/xml_tester_fifo_%d", int (::getpid ()));
+                if (::mkfifo (fifo_name, 0600) == 0)  {
+                    const   int fifo_fd = ::open (fifo_name, O_RDWR);
+
+                    if (fifo_fd >= 0)  {
+                        static  const   char    bad_doc [] = "<A><B></A>";
+
+                        if (::write (fifo_fd, bad_doc,
+                                     sizeof (bad_doc) - 1) > 0)  {
+                            pipe_parser.set_file_input (
+                                XMLParser::fi_read_ahead);
+                            fifo_parsed = pipe_parser.parse_file (fifo_name);
+                        }
+                        ::close (fifo_fd);
+                    }
+                    ::unlink (fifo_name);
+                }
+                std::cout << "Abandoned FIFO parse: "
+                          << (! fifo_parsed ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the attribute escaping. The dump, which has no
+               // DOCTYPE, must parse back to the same tree.
+               //
+                XMLTreeNodes::attr_vector   rt_attrs;
+                XMLTreeNodes                rt_pn (rt_attrs);
+                XMLParser                   rt_parser (
+                    rt_pn, rt_attrs,
+                    XERCES_CPP_NAMESPACE::SAXParser::Val_Never,
+                    doNamespaces);
+                std::string                 compact_dump;
+                std::string                 str6;
+
+                pn.dump_xml (compact_dump, XMLTreeNodes::df_compact);
+                rt_parser.parse_string (compact_dump.c_str (),
+                                        compact_dump.size ());
+                rt_pn.dump_xml (str6);
+                std::cout << "Dump round trip: "
+                          << (! rt_parser.has_fatal_error () && str == str6
+                                  ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // A default (fi_xerces) parse of a named pipe. The writer
+               // connects when the parser opens the FIFO, and all it
+               // writes must be parsed. If the parser closed the FIFO
+               // early, the write would fail (SIGPIPE is ignored for that).
+               //
+                XMLTreeNodes::attr_vector   fifo_attrs;
+                XMLTreeNodes                fifo_pn (fifo_attrs);
+                XMLParser                   fifo_parser (
+                    fifo_pn, fifo_attrs,
+                    XERCES_CPP_NAMESPACE::SAXParser::Val_Never,
+                    doNamespaces);
+                bool                        fifo_written = false;
+                std::string                 str8;
+
+                std::signal (SIGPIPE, SIG_IGN);
+                if (::mkfifo (fifo_name, 0600) == 0)  {
+                    std::thread fifo_writer ([&fifo_written, &compact_dump,
+                                              &fifo_name] ()  {
+                        const   int fd = ::open (fifo_name, O_WRONLY);
+
+                        if (fd >= 0)  {
+                            fifo_written =
+                                ::write (fd, compact_dump.c_str (),
+                                         compact_dump.size ()) ==
+                                    ssize_t (compact_dump.size ());
+                            ::close (fd);
+                        }
+                    });
+
+                    fifo_parser.parse_file (fifo_name);
+                    fifo_writer.join ();
+                    ::unlink (fifo_name);
+                    fifo_pn.dump_xml (str8);
+                }
+                std::cout << "Default FIFO parse: "
+                          << (fifo_written &&
+                              ! fifo_parser.has_fatal_error () &&
+                              str == str8 ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the writev() output. A small scratch buffer makes
+               // it flush many times.
+               //
+                std::FILE   *tmp_file = std::tmpfile ();
+                std::string iovec_dump;
+
+                if (tmp_file != NULL)  {
+                    XMLIovecSink    sink (::fileno (tmp_file), 256, 16);
+                    char            buffer [4096];
+                    std::size_t     n;
+
+                    pn.dump_to_sink (sink);
+                    sink.flush ();
+                    std::rewind (tmp_file);
+                    while ((n = std::fread (buffer, 1, sizeof (buffer),
+                                            tmp_file)) > 0)
+                        iovec_dump.append (buffer, n);
+                    std::fclose (tmp_file);
+                }
+                std::cout << "Iovec sink: "
+                          << (str == iovec_dump ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Valid UTF-8 is kept. A stray byte becomes a char reference.
+               //
+                std::string literal;
+
+                XMLWriter::encode_literal (
+                    "a<b & 'c' \"d\"\t\xC3\xA9\xE2\x82\xAC\xFF\x7F",
+                    literal);
+                std::cout << "Literal encoding: "
+                          << (literal == "a&lt;b &amp; &apos;c&apos; "
+                                         "&quot;d&quot;&#9;\xC3\xA9"
+                                         "\xE2\x82\xAC&#255;&#127;"
+                                  ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the reference decoder. The buffer is filled past
+               // the text, so a missing null terminator shows.
+               //
+                const   auto    decode = [] (const std::string &text)  {
+                    std::vector<char>   buffer (text.size () + 2, '#');
+
+                    std::copy (text.begin (), text.end (), buffer.begin ());
+
+                    const   std::size_t len =
+                        XMLString::decode_references (&(buffer [0]),
+                                                      text.size ());
+
+                    return (buffer [len] == 0
+                                ? std::string (&(buffer [0]), len)
+                                : std::string ("NOT TERMINATED"));
+                };
+                const   char    *const  malformed =
+                    "&#0; &#x0; &#xD800; &#57343; &#x110000; &#12a; &#; "
+                    "&#x; &bogus; &amp &lt & &";
+
+                std::cout << "Reference decoding: "
+                          << (decode ("&lt;&gt;&amp;&quot;&apos;") ==
+                                  "<>&\"'" &&
+                              decode ("&#233;&#xE9;") ==
+                                  "\xC3\xA9\xC3\xA9" &&
+                              decode ("&#8364;&#x20ac;") ==
+                                  "\xE2\x82\xAC\xE2\x82\xAC" &&
+                              decode ("&#128512;&#x1F600;") ==
+                                  "\xF0\x9F\x98\x80\xF0\x9F\x98\x80" &&
+                              decode ("a &amp;lt; b&#65;c") == "a &lt; bAc" &&
+                              decode (malformed) == malformed &&
+                              decode ("no references here") ==
+                                  "no references here" &&
+                              decode ("") == ""
+                                  ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the pull parser. It must see as many elements as
+               // there are nodes in the tree.
+               //
+                const   std::size_t nodes =
+                    std::distance (pn.preorder_begin (), pn.preorder_end ());
+                XMLCursor           cursor (valScheme, doNamespaces);
+                std::size_t         elements = 0;
+
+                cursor.open_file (xmlFile);
+                while (cursor.next () != XMLCursor::ce_end_document)
+                    if (cursor.event () == XMLCursor::ce_start_element)
+                        elements += 1;
+                std::cout << "Cursor: "
+                          << (! cursor.has_fatal_error () &&
+                              elements == nodes ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // A validation error is recorded, and the cursor goes on to
+               // the end of the document
+               //
+                static  const   char    invalid_doc [] =
+                    "<!DOCTYPE A [<!ELEMENT A (B)><!ELEMENT B EMPTY>]>"
+                    "<A><C/><B/></A>";
+                XMLCursor               validating_cursor (
+                    XERCES_CPP_NAMESPACE::SAXParser::Val_Always);
+                std::size_t             invalid_elements = 0;
+
+                validating_cursor.open_string (invalid_doc,
+                                               sizeof (invalid_doc) - 1);
+                while (validating_cursor.next () != XMLCursor::ce_end_document)
+                    if (validating_cursor.event () ==
+                            XMLCursor::ce_start_element)
+                        invalid_elements += 1;
+                std::cout << "Cursor validation errors: "
+                          << (validating_cursor.has_error () &&
+                              ! validating_cursor.has_fatal_error () &&
+                              invalid_elements == 3 ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the whole tree iterators. The pre-order walk with
+               // exit events must match the cursor's events one for one.
+               //
+                bool                        events_match = true;
+                XMLTreeNodes::level_queue   level_queue;
+
+                cursor.open_file (xmlFile);
+                for (XMLTreeNodes::const_preorder_iterator itr =
+                         pn.preorder_begin (true);
+                     itr != pn.preorder_end (); ++itr)  {
+                    const   XMLCursor::Event    event =
+                        itr.event () == XMLTreeNodes::te_enter
+                            ? XMLCursor::ce_start_element
+                            : XMLCursor::ce_end_element;
+
+                    events_match = events_match &&
+                        cursor.next () == event &&
+                        cursor.depth () == itr.depth () + 1 &&
+                        ! ::strcmp (cursor.name (), itr->get_name ());
+                }
+                std::cout << "Tree iterators: "
+                          << (events_match &&
+                              cursor.next () == XMLCursor::ce_end_document &&
+                              std::distance (pn.postorder_begin (),
+                                             pn.postorder_end ()) ==
+                                  std::ptrdiff_t (nodes) &&
+                              std::distance (pn.level_begin (level_queue),
+                                             pn.level_end ()) ==
+                                  std::ptrdiff_t (nodes)
+                                  ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the parallel visitor. A small grain makes idle
+               // threads split off small pieces of even this small tree.
+               // The second visit reuses the threads of the first.
+               //
+                XMLParallelVisitor  visitor (4, 2);
+                std::size_t         name_chars = 0;
+                const   auto        count_chars =
+                    [] (std::size_t &chars, const XMLTreeNodes &node)  {
+                        chars += ::strlen (node.get_name ());
+                    };
+                const   auto        add = [] (std::size_t a, std::size_t b)  {
+                    return (a + b);
+                };
+
+                for (XMLTreeNodes::const_preorder_iterator itr =
+                         pn.preorder_begin ();
+                     itr != pn.preorder_end (); ++itr)
+                    name_chars += ::strlen (itr->get_name ());
+                std::cout << "Parallel visitor: "
+                          << (visitor.reduce (pn, std::size_t (0),
+                                              count_chars, add) ==
+                                  name_chars &&
+                              visitor.reduce (pn, std::size_t (0),
+                                              count_chars, add) ==
+                                  name_chars
+                                  ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the typed attribute accessors
+               //
+                long            process_id = 0;
+                XMLTimeStamp    first_start;
+                XMLTimeStamp    start;
+
+                cursor.open_file (xmlFile);
+                while (cursor.next () != XMLCursor::ce_end_document)
+                    if (cursor.event () == XMLCursor::ce_start_element)  {
+                        cursor.attr_as ("CLIENT_PROCESS_ID", process_id);
+                        if (cursor.attr_as ("START", start) == xcs_ok &&
+                            first_start.year == 0)
+                            first_start = start;
+                    }
+                std::cout << "Typed attributes: "
+                          << (process_id == 23456 &&
+                              first_start.packed () == 20100716083000ULL
+                                  ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // A conversion that fails leaves the value alone
+               //
+                double  untouched = 0.5;
+                float   untouched_f = 0.5f;
+
+                std::cout << "Failed conversions: "
+                          << (XMLconvert ("abc", untouched) == xcs_invalid &&
+                              XMLconvert ("1e", untouched) == xcs_invalid &&
+                              XMLconvert ("1e-400", untouched) ==
+                                  xcs_out_of_range &&
+                              XMLconvert ("1e-400", untouched_f) ==
+                                  xcs_out_of_range &&
+                              XMLconvert ("99999999999999999999",
+                                          process_id) == xcs_out_of_range &&
+                              untouched == 0.5 && untouched_f == 0.5f &&
+                              process_id == 23456
+                                  ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the struct binding
+               //
+                XMLBinder<DataRequestGroup> binder (valScheme);
+                DataRequestGroup            group;
+                std::size_t                 fields = 0;
+
+                binder.parse_file (xmlFile, group);
+                for (const auto &symbol : group.request.symbols)
+                    fields += symbol.fields.size ();
+                std::cout << "Binder: "
+                          << (! binder.has_fatal_error () &&
+                              group.request.client_process_id == 23456 &&
+                              group.request.symbols.size () == 2 &&
+                              group.request.symbols [0].reference ==
+                                  20100716 &&
+                              fields == 4
+                                  ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the bindings generated from data_query.dtd. What
+               // XMLwrite() writes must bind back to the same structs.
+               //
+                XMLBinder<data_query::HmRequestGroup>   gen_binder (valScheme,
+                                                                    true);
+                data_query::HmRequestGroup              gen_group;
+                std::ostringstream                      gen_strm;
+                std::ostringstream                      gen_strm2;
+                bool                                    gen_bound =
+                    gen_binder.parse_file (xmlFile, gen_group);
+
+                {
+                    XMLStreamWriter<std::ostream>   gen_writer (gen_strm);
+
+                    data_query::XMLwrite (gen_writer, gen_group);
+                }
+
+                const   std::string gen_xml = gen_strm.str ();
+
+                gen_bound = gen_bound &&
+                    gen_binder.parse_string (gen_xml.c_str (), gen_xml.size (),
+                                             gen_group);
+                {
+                    XMLStreamWriter<std::ostream>   gen_writer (gen_strm2);
+
+                    data_query::XMLwrite (gen_writer, gen_group);
+                }
+                std::cout << "Generated binding: "
+                          << (gen_bound &&
+                              gen_strm2.str () == gen_xml &&
+                              gen_group.hm_request.size () == 1 &&
+                              gen_group.hm_request [0].client_process_id &&
+                              *gen_group.hm_request [0].client_process_id ==
+                                  23456 &&
+                              gen_group.hm_request [0].symbol.size () == 2
+                                  ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Strict binding checks the structure as it parses: required
+               // attributes and children, enumerated values and children
+               // that may occur only once
+               //
+                XMLBinder<data_query::HmRequestGroup>   strict_binder (
+                    XERCES_CPP_NAMESPACE::SAXParser::Val_Never, true);
+                XMLBinder<DataRequestGroup>             strict_binder2 (
+                    XERCES_CPP_NAMESPACE::SAXParser::Val_Never, true);
+                const   auto    strict_error =
+                    [&] (const char *xml) -> std::string  {
+                        strict_binder.parse_string (xml, ::strlen (xml),
+                                                   gen_group);
+                        return (strict_binder.fatal_error ());
+                    };
+                const   char    *const  repeated_xml =
+                    "<HM_REQUEST_GROUP ID=\"g\"><HM_REQUEST ID=\"1\"/>"
+                    "<HM_REQUEST ID=\"2\"/></HM_REQUEST_GROUP>";
+                const   bool    lax_repeated =
+                    binder.parse_string (repeated_xml,
+                                         ::strlen (repeated_xml), group) &&
+                    group.request.id == "1";
+
+                strict_binder2.parse_string (repeated_xml,
+                                             ::strlen (repeated_xml), group);
+                std::cout << "Strict binding checks: "
+                          << (strict_error (
+                                  "<HM_REQUEST_GROUP ID=\"g\">"
+                                  "<HM_REQUEST ID=\"1\" TARGET=\"T\" "
+                                  "TYPE=\"X\"><SYMBOL ID=\"I\" "
+                                  "START=\"20100716083000\" "
+                                  "END=\"20100716093000\" "
+                                  "RETURN_TYPE=\"UNADJUSTED\"/>"
+                                  "</HM_REQUEST></HM_REQUEST_GROUP>")
+                                  .empty () &&
+                              strict_error (
+                                  "<HM_REQUEST_GROUP><HM_REQUEST ID=\"1\" "
+                                  "TARGET=\"T\" TYPE=\"X\"/>"
+                                  "</HM_REQUEST_GROUP>") ==
+                                  "BINDING ERROR: missing attribute 'ID' in "
+                                  "'HM_REQUEST_GROUP'" &&
+                              strict_error ("<HM_REQUEST_GROUP ID=\"g\"/>") ==
+                                  "BINDING ERROR: missing element "
+                                  "'HM_REQUEST' in 'HM_REQUEST_GROUP'" &&
+                              strict_error (
+                                  "<HM_REQUEST_GROUP ID=\"g\">"
+                                  "<HM_REQUEST ID=\"1\" TARGET=\"T\" "
+                                  "TYPE=\"X\"><SYMBOL ID=\"I\" "
+                                  "START=\"20100716083000\" "
+                                  "END=\"20100716093000\" "
+                                  "RETURN_TYPE=\"RAW\"/>"
+                                  "</HM_REQUEST></HM_REQUEST_GROUP>") ==
+                                  "BINDING ERROR: invalid value of attribute "
+                                  "'RETURN_TYPE' ('RAW')" &&
+                              strict_binder2.fatal_error () ==
+                                  "BINDING ERROR: repeated element "
+                                  "'HM_REQUEST'" &&
+                              lax_repeated
+                                  ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // Testing the asynchronous ingestion
+               //
+                XMLAsyncIngest              ingest;
+                XMLAsyncIngest::DocumentPtr doc =
+                    ingest.submit (xmlFile).get ();
+                std::string                 str4;
+
+                doc->get_root ().dump_xml (str4);
+                std::cout << "Async ingest"
+                          << (ingest.uses_io_uring () ? " (io_uring): "
+                                                      : ": ")
+                          << (str == str4 ? "OK" : "FAILED")
+                          << std::endl << std::endl;
+
+               // A named pipe without a writer must not block submit().
+               // The document is written after it is submitted.
+               //
+                bool    fifo_ingested = false;
+
+                if (::mkfifo (fifo_name, 0600) == 0)  {
+                    std::future<XMLAsyncIngest::DocumentPtr> fifo_doc =
+                        ingest.submit (fifo_name);
+                    const   int fifo_fd = ::open (fifo_name, O_WRONLY);
+
+                    if (fifo_fd >= 0)  {
+                        const   bool    written =
+                            ::write (fifo_fd, str.c_str (), str.size ()) ==
+                                ssize_t (str.size ());
+                        std::string     str7;
+
+                        ::close (fifo_fd);
+                        fifo_ingested = written;
+                        fifo_doc.get ()->get_root ().dump_xml (str7);
+                        fifo_ingested = fifo_ingested && str == str7;
+                    }
+                    ::unlink (fifo_name);
+                }
+                std::cout << "Async FIFO ingest: "
+                          << (fifo_ingested ? "OK" : "FAILED")
+                          << std::endl << std::endl;
             }
 
            // Measure the performance of the XMLTreeNodes destructor